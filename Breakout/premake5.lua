@@ -15,6 +15,7 @@ project "Breakout"
         externalwarnings "Default" -- Default
         files "res/icon/icon.rc"
         buildoptions { "/sdl" }
+        defines "_CRT_SECURE_NO_WARNINGS" -- /sdl turns the deprecation of sscanf(), fopen()... into errors
         disablewarnings "4244" -- float to int without cast
 
     filter { "toolset:gcc* or toolset:clang*" }
@@ -92,14 +93,18 @@ project "Breakout"
     }
 
     includedirs {
-        RaylibDir .. "/src"
+        RaylibDir .. "/src",
+        SimulationDir .. "/src"
     }
 
     externalincludedirs {
         RaylibDir .. "/src"
     }
 
-    links "raylib"
+    links {
+        "Simulation",
+        "raylib"
+    }
 
     filter "system:windows"
         links {
@@ -116,7 +121,8 @@ project "Breakout"
             "X11",
             "rt",
             "dl",
-            "m"
+            "m",
+            "pthread"
         }
 
     filter "system:macosx"
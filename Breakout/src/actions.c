@@ -0,0 +1,234 @@
+#include <string.h>
+
+#include "actions.h"
+
+#define ACTION(action) ((uint64_t)1 << (action))
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof(*a))
+
+
+enum ActionSource
+{
+    SourceKeyPressed,
+    SourceKeyRepeat, // pressed or repeated by the os while held
+    SourceKeyDown,
+    SourceButtonPressed,
+    SourceButtonDown,
+    SourceAxisNegative, // left stick x
+    SourceAxisPositive
+};
+
+
+// An input triggers every action in its mask, so each one is polled once however many actions share it
+struct ActionBinding
+{
+    enum ActionSource source;
+    int code;
+    uint64_t actions;
+};
+
+
+static const struct ActionBinding sg_Bindings[] = {
+    { SourceKeyPressed, KEY_A,      ACTION(ActionStart) },
+    { SourceKeyPressed, KEY_D,      ACTION(ActionStart) },
+    { SourceKeyPressed, KEY_LEFT,   ACTION(ActionStart) },
+    { SourceKeyPressed, KEY_RIGHT,  ACTION(ActionStart) },
+    { SourceKeyPressed, KEY_SPACE,  ACTION(ActionStart) | ACTION(ActionDismiss) },
+    { SourceKeyPressed, KEY_ESCAPE, ACTION(ActionStart) | ACTION(ActionPause) | ACTION(ActionDismiss) },
+    { SourceKeyPressed, KEY_R,      ACTION(ActionReset) | ACTION(ActionDismiss) },
+    { SourceKeyPressed, KEY_L,      ACTION(ActionResetAll) },
+    { SourceKeyPressed, KEY_N,      ACTION(ActionSpawnBalls) },
+    { SourceKeyPressed, KEY_X,      ACTION(ActionXRay) },
+    { SourceKeyPressed, KEY_M,      ACTION(ActionMute) },
+    { SourceKeyPressed, KEY_F3,     ACTION(ActionControlls) },
+    { SourceKeyPressed, KEY_F,      ACTION(ActionShowFps) },
+    { SourceKeyPressed, KEY_T,      ACTION(ActionShowProfiler) },
+    { SourceKeyPressed, KEY_F9,     ACTION(ActionFlushTrace) },
+    { SourceKeyPressed, KEY_G,      ACTION(ActionBottomHitbox) },
+    { SourceKeyPressed, KEY_P,      ACTION(ActionPaddleHitbox) },
+    { SourceKeyPressed, KEY_B,      ACTION(ActionShowStats) },
+    { SourceKeyPressed, KEY_I,      ACTION(ActionIncreaseBallSpeed) },
+    { SourceKeyPressed, KEY_O,      ACTION(ActionAutoMove) },
+    { SourceKeyPressed, KEY_U,      ACTION(ActionAutoRestart) },
+    { SourceKeyPressed, KEY_E,      ACTION(ActionEventDriven) },
+    { SourceKeyPressed, KEY_K,      ACTION(ActionMultiBall) },
+    { SourceKeyPressed, KEY_Q,      ACTION(ActionLimitFps) },
+    { SourceKeyRepeat,  KEY_PERIOD, ACTION(ActionFpsUp) },
+    { SourceKeyRepeat,  KEY_COMMA,  ACTION(ActionFpsDown) },
+    { SourceKeyRepeat,  KEY_W,      ACTION(ActionSpeedUp) },
+    { SourceKeyRepeat,  KEY_S,      ACTION(ActionSpeedDown) },
+    { SourceKeyRepeat,  KEY_UP,     ACTION(ActionSpeedUpFine) },
+    { SourceKeyRepeat,  KEY_DOWN,   ACTION(ActionSpeedDownFine) },
+    { SourceKeyDown,    KEY_TWO,    ACTION(ActionSpeedUpFast) },
+    { SourceKeyDown,    KEY_ONE,    ACTION(ActionSpeedDownFast) },
+    { SourceKeyDown,    KEY_A,      ACTION(ActionMoveLeft) },
+    { SourceKeyDown,    KEY_LEFT,   ACTION(ActionMoveLeft) },
+    { SourceKeyDown,    KEY_D,      ACTION(ActionMoveRight) },
+    { SourceKeyDown,    KEY_RIGHT,  ACTION(ActionMoveRight) },
+
+    { SourceButtonPressed, GAMEPAD_BUTTON_LEFT_FACE_LEFT,   ACTION(ActionStart) },
+    { SourceButtonPressed, GAMEPAD_BUTTON_LEFT_FACE_RIGHT,  ACTION(ActionStart) },
+    { SourceButtonPressed, GAMEPAD_BUTTON_RIGHT_FACE_DOWN,  ACTION(ActionStart) | ACTION(ActionPause) | ACTION(ActionDismiss) },
+    { SourceButtonPressed, GAMEPAD_BUTTON_MIDDLE_RIGHT,     ACTION(ActionStart) | ACTION(ActionPause) },
+    { SourceButtonPressed, GAMEPAD_BUTTON_RIGHT_FACE_UP,    ACTION(ActionReset) | ACTION(ActionDismiss) },
+    { SourceButtonPressed, GAMEPAD_BUTTON_RIGHT_FACE_LEFT,  ACTION(ActionXRay) },
+    { SourceButtonPressed, GAMEPAD_BUTTON_RIGHT_FACE_RIGHT, ACTION(ActionMute) },
+    { SourceButtonPressed, GAMEPAD_BUTTON_RIGHT_TRIGGER_2,  ACTION(ActionControlls) },
+    { SourceButtonPressed, GAMEPAD_BUTTON_MIDDLE_LEFT,      ACTION(ActionShowFps) },
+    { SourceButtonPressed, GAMEPAD_BUTTON_RIGHT_THUMB,      ACTION(ActionBottomHitbox) },
+    { SourceButtonPressed, GAMEPAD_BUTTON_LEFT_THUMB,       ACTION(ActionPaddleHitbox) },
+    { SourceButtonPressed, GAMEPAD_BUTTON_LEFT_TRIGGER_1,   ACTION(ActionShowStats) },
+    { SourceButtonPressed, GAMEPAD_BUTTON_RIGHT_TRIGGER_1,  ACTION(ActionIncreaseBallSpeed) },
+    { SourceButtonPressed, GAMEPAD_BUTTON_LEFT_FACE_UP,     ACTION(ActionSpeedUpFine) },
+    { SourceButtonPressed, GAMEPAD_BUTTON_LEFT_FACE_DOWN,   ACTION(ActionSpeedDownFine) },
+    { SourceButtonDown,    GAMEPAD_BUTTON_LEFT_FACE_LEFT,   ACTION(ActionMoveLeft) },
+    { SourceButtonDown,    GAMEPAD_BUTTON_LEFT_FACE_RIGHT,  ACTION(ActionMoveRight) },
+    { SourceAxisNegative,  GAMEPAD_AXIS_LEFT_X,             ACTION(ActionMoveLeft) | ACTION(ActionStart) },
+    { SourceAxisPositive,  GAMEPAD_AXIS_LEFT_X,             ACTION(ActionMoveRight) | ACTION(ActionStart) }
+};
+
+_Static_assert(ARRAY_SIZE(sg_Bindings) <= 64, "Actions.keys_down has a bit per binding");
+
+
+bool action_source_active(enum ActionSource source, int code)
+{
+    switch (source)
+    {
+    case SourceKeyPressed:
+        return IsKeyPressed(code);
+    case SourceKeyRepeat:
+        return IsKeyPressed(code) || IsKeyPressedRepeat(code);
+    case SourceKeyDown:
+        return IsKeyDown(code);
+    case SourceButtonPressed:
+        return IsGamepadButtonPressed(0, code);
+    case SourceButtonDown:
+        return IsGamepadButtonDown(0, code);
+    case SourceAxisNegative:
+        return GetGamepadAxisMovement(0, code) < 0;
+    case SourceAxisPositive:
+        return GetGamepadAxisMovement(0, code) > 0;
+    default:
+        return false;
+    }
+}
+
+
+void actions_init(struct Actions* actions)
+{
+    memset(actions, 0, sizeof(struct Actions));
+}
+
+
+uint64_t actions_of_keys(uint64_t keys_down)
+{
+    uint64_t held = 0;
+    for (size_t i = 0; i < ARRAY_SIZE(sg_Bindings); ++i)
+    {
+        if ((keys_down >> i) & 1)
+            held |= sg_Bindings[i].actions;
+    }
+    return held;
+}
+
+
+// Replays raylib's timed key and mouse events on the held keys of the last sample
+void actions_sample_changes(struct Actions* actions, uint64_t gamepad_held)
+{
+    int count;
+    const TimedInputEvent* events = GetTimedInputEvents(&count);
+    uint64_t keys_down = actions->keys_down;
+    Vector2 mouse = actions->mouse;
+
+    actions->start = (struct ActionState){ actions->time, actions_of_keys(keys_down) | gamepad_held, mouse };
+    actions->change_count = 0;
+    for (int e = 0; e < count && actions->change_count < ACTIONS_MAX_CHANGES; ++e)
+    {
+        if (events[e].type == TIMED_INPUT_MOUSE_MOVE)
+        {
+            mouse = events[e].position;
+        }
+        else
+        {
+            for (size_t i = 0; i < ARRAY_SIZE(sg_Bindings); ++i)
+            {
+                if (sg_Bindings[i].source != SourceKeyDown || sg_Bindings[i].code != events[e].key)
+                    continue;
+                if (events[e].type == TIMED_INPUT_KEY_DOWN)
+                    keys_down |= (uint64_t)1 << i;
+                else
+                    keys_down &= ~((uint64_t)1 << i);
+            }
+        }
+        actions->changes[actions->change_count++] = (struct ActionState){ events[e].time, actions_of_keys(keys_down) | gamepad_held, mouse };
+    }
+}
+
+
+// Time of the first timed input event that holds the action, the sample's if none does (pressed actions, the gamepad, the web)
+double actions_held_since(const struct Actions* actions, enum Action action, double sample_time)
+{
+    for (size_t i = 0; i < actions->change_count; ++i)
+    {
+        if (action_held(&actions->changes[i], action))
+            return actions->changes[i].time;
+    }
+    return sample_time;
+}
+
+
+void actions_sample(struct Actions* actions)
+{
+    const bool gamepad = IsGamepadAvailable(0);
+    uint64_t active = 0;
+    uint64_t keys_down = 0;
+    uint64_t gamepad_held = 0;
+    for (size_t i = 0; i < ARRAY_SIZE(sg_Bindings); ++i)
+    {
+        const struct ActionBinding* binding = &sg_Bindings[i];
+        const bool held = binding->source == SourceKeyDown || binding->source >= SourceButtonDown;
+        if (binding->source >= SourceButtonPressed && !gamepad)
+            continue;
+        if ((binding->actions & ~active) == 0 && !held)
+            continue; // nothing new to trigger, held inputs are needed for the changes
+        if (!action_source_active(binding->source, binding->code))
+            continue;
+
+        active |= binding->actions;
+        if (binding->source == SourceKeyDown)
+            keys_down |= (uint64_t)1 << i;
+        else if (held)
+            gamepad_held |= binding->actions;
+    }
+
+    // the gamepad is polled, it doesn't have events and holds the same for the whole frame
+    actions_sample_changes(actions, gamepad_held);
+
+    const double now = GetTime();
+    actions->started = active & ~actions->active;
+    for (int action = 0; action < ActionCount; ++action)
+    {
+        if ((actions->started >> action) & 1)
+            actions->since[action] = actions_held_since(actions, (enum Action)action, now);
+    }
+
+    actions->active = active;
+    actions->time = now;
+    actions->mouse = GetMousePosition();
+    actions->keys_down = keys_down;
+    actions->held = actions_of_keys(keys_down) | gamepad_held;
+}
+
+
+struct ActionState actions_at(const struct Actions* actions, double time)
+{
+    const struct ActionState end = { actions->time, actions->held, actions->mouse };
+
+    // without events (e.g. on the web) the sample is all there is, events past the capacity only show up in it as well
+    if (actions->change_count == 0 || time >= actions->time)
+        return end;
+
+    const struct ActionState* state = &actions->start;
+    for (size_t i = 0; i < actions->change_count && actions->changes[i].time <= time; ++i)
+        state = &actions->changes[i];
+    return *state;
+}
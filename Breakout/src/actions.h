@@ -0,0 +1,97 @@
+#ifndef ACTIONS_H
+#define ACTIONS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "raylib.h"
+
+/*
+    Everything the player can do, sampled once per frame from the binding table in actions.c.
+    The handlers of the states only read the snapshot, no key is polled twice per frame and
+    changing a binding means changing one line of the table.
+*/
+enum Action
+{
+    ActionMoveLeft,      // held
+    ActionMoveRight,     // held
+    ActionStart,         // start or resume from a menu
+    ActionPause,
+    ActionDismiss,       // leave the success or failed screen
+    ActionReset,
+    ActionResetAll,
+    ActionSpawnBalls,
+    ActionXRay,
+    ActionMute,
+    ActionControlls,
+    ActionShowFps,
+    ActionShowProfiler,
+    ActionFlushTrace,
+    ActionBottomHitbox,
+    ActionPaddleHitbox,
+    ActionShowStats,
+    ActionIncreaseBallSpeed,
+    ActionAutoMove,
+    ActionAutoRestart,
+    ActionEventDriven,
+    ActionMultiBall,
+    ActionLimitFps,
+    ActionFpsUp,         // repeats while held
+    ActionFpsDown,
+    ActionSpeedUpFast,   // every frame while held
+    ActionSpeedDownFast,
+    ActionSpeedUp,       // repeats while held
+    ActionSpeedDown,
+    ActionSpeedUpFine,
+    ActionSpeedDownFine,
+    ActionCount
+};
+
+#define ACTIONS_MAX_CHANGES 256 // timed input events per frame, later ones only show up in the frame's final state
+
+
+// Held actions and the mouse at a point in time
+struct ActionState
+{
+    double time;
+    uint64_t held; // bit per Action, only the ones bound to held inputs
+    Vector2 mouse;
+};
+
+
+struct Actions
+{
+    uint64_t active;              // bit per Action, set if it triggered this frame
+    uint64_t started;             // bit per Action, set if it is active this frame but wasn't in the last one
+    double time;                  // GetTime() of the sample
+    double since[ActionCount];    // when the action became active, the time of its timed input event if it has one, otherwise of the sample
+    Vector2 mouse;
+    uint64_t held;                // bit per Action, only the ones bound to held inputs
+    uint64_t keys_down;           // bit per binding in the table, held keys at the sample
+    // raylib's timed input events since the last sample, what was held when in between the two samples
+    struct ActionState start;     // at the last sample
+    struct ActionState changes[ACTIONS_MAX_CHANGES];
+    size_t change_count;
+};
+
+
+void actions_init(struct Actions* actions);
+void actions_sample(struct Actions* actions); // once per frame, before any state handler
+struct ActionState actions_at(const struct Actions* actions, double time); // held actions and the mouse at a time since the last sample
+
+static inline bool action_active(const struct Actions* actions, enum Action action)
+{
+    return (actions->active >> action) & 1;
+}
+
+static inline bool action_started(const struct Actions* actions, enum Action action)
+{
+    return (actions->started >> action) & 1;
+}
+
+static inline bool action_held(const struct ActionState* state, enum Action action)
+{
+    return (state->held >> action) & 1;
+}
+
+#endif // ACTIONS_H
@@ -0,0 +1,449 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <math.h>
+
+#include "batch.h"
+#include "replay.h"
+
+#define MIN(a, b) (a < b ? a : b)
+#define MAX(a, b) (a > b ? a : b)
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof(*a))
+
+#define BATCH_WIDTH         1200 // same field as the default window
+#define BATCH_HEIGHT        750
+#define BATCH_PADDLE_HEIGHT 30
+
+
+enum BatchOutcome
+{
+    BatchFailed,
+    BatchWon,
+    BatchTimeout
+};
+
+
+struct BatchResult
+{
+    uint64_t seed;
+    enum BatchOutcome outcome;
+    uint32_t steps;
+    uint32_t paddle_hits;
+    uint32_t bricks;
+    float peak_speed;
+};
+
+
+// Decides the player's input for the next step, a new controller only has to be added to sg_Controllers
+struct BatchController
+{
+    const char* name;
+    bool auto_move; // the simulation moves the paddle itself
+    void (*control)(const struct GameState* state, struct InputFrame* input);
+};
+
+
+struct BatchContext
+{
+    const struct BatchOptions* options;
+    struct BatchResult* results;
+    struct Arena* arenas; // one per worker
+    int bricks_hor;
+    int bricks_ver;
+};
+
+
+// Plays like someone on the keyboard, the paddle moves at PADDLE_SPEED until the ball is over its middle
+void controller_keys(const struct GameState* state, struct InputFrame* input)
+{
+    const Rectangle paddle = state->objects.paddle;
+    const float target = state->objects.ball.center.x;
+    if (target < paddle.x + paddle.width * 0.25f)
+        input->actions |= InputMoveLeft;
+    else if (target > paddle.x + paddle.width * 0.75f)
+        input->actions |= InputMoveRight;
+}
+
+
+static const struct BatchController sg_Controllers[] = {
+    { "auto", true,  NULL },           // the auto_move setting, never misses
+    { "keys", false, controller_keys },
+    { "idle", false, NULL }            // doesn't move at all, baseline
+};
+
+
+struct BatchOptions batch_default_options(void)
+{
+    struct BatchOptions options;
+    options.games = 0;
+    options.seed = 1;
+    options.out_path = NULL;
+    options.binary = false;
+    options.controller = 0;
+    options.ball_speed = 500.f;
+    options.paddle_width = 230;
+    options.increase_ball_speed = true;
+    options.event_driven = false;
+    options.rate = 240;
+    options.max_seconds = 600;
+    options.replay_path = NULL;
+    return options;
+}
+
+
+// Any seed printed to --out can be passed back in, so the whole u64 range is taken. strtoull() alone would wrap negative numbers
+bool batch_parse_seed(const char* value, unsigned long long* seed)
+{
+    if (*value < '0' || *value > '9')
+        return false;
+
+    char* end;
+    errno = 0;
+    const unsigned long long number = strtoull(value, &end, 10);
+    if (errno != 0 || *end != '\0')
+        return false;
+
+    *seed = number;
+    return true;
+}
+
+
+// --simulate <games> --seed <n> --out <file> --binary --controller <auto|keys|idle> --ball-speed <f>
+// --paddle-width <n> --speed-increase <0|1> --event-driven --rate <steps per second> --max-seconds <n> --replay <file>
+bool batch_parse_arg(struct BatchOptions* options, int argc, char** argv, int* i)
+{
+    const char* arg = argv[*i];
+    if (strcmp(arg, "--binary") == 0)
+    {
+        options->binary = true;
+        return true;
+    }
+
+    if (strcmp(arg, "--event-driven") == 0)
+    {
+        options->event_driven = true;
+        return true;
+    }
+
+    if (*i + 1 >= argc)
+        return false;
+
+    const char* value = argv[*i + 1];
+    int number;
+    bool consumed = true;
+    if (strcmp(arg, "--simulate") == 0 && sscanf(value, "%d", &number) == 1)
+        options->games = MAX(0, number);
+    else if (strcmp(arg, "--seed") == 0)
+        consumed = batch_parse_seed(value, &options->seed);
+    else if (strcmp(arg, "--out") == 0)
+        options->out_path = value;
+    else if (strcmp(arg, "--replay") == 0)
+        options->replay_path = value;
+    else if (strcmp(arg, "--ball-speed") == 0 && sscanf(value, "%f", &options->ball_speed) == 1)
+        options->ball_speed = MAX(1.f, options->ball_speed);
+    else if (strcmp(arg, "--paddle-width") == 0 && sscanf(value, "%d", &number) == 1)
+        options->paddle_width = MAX(1, MIN(number, BATCH_WIDTH));
+    else if (strcmp(arg, "--speed-increase") == 0 && sscanf(value, "%d", &number) == 1)
+        options->increase_ball_speed = number != 0;
+    else if (strcmp(arg, "--rate") == 0 && sscanf(value, "%d", &number) == 1)
+        options->rate = MAX(1, number);
+    else if (strcmp(arg, "--max-seconds") == 0 && sscanf(value, "%d", &number) == 1)
+        options->max_seconds = MAX(1, number);
+    else if (strcmp(arg, "--controller") == 0)
+    {
+        consumed = false;
+        for (size_t c = 0; c < ARRAY_SIZE(sg_Controllers); ++c)
+        {
+            if (strcmp(value, sg_Controllers[c].name) == 0)
+            {
+                options->controller = (int)c;
+                consumed = true;
+            }
+        }
+    }
+    else
+        consumed = false;
+
+    if (consumed)
+        ++*i;
+    return consumed;
+}
+
+
+struct BatchResult batch_play(const struct BatchOptions* options, struct Arena* arena, int bricks_hor, int bricks_ver, uint64_t seed)
+{
+    const struct BatchController* controller = &sg_Controllers[options->controller];
+
+    struct GameState state = { 0 };
+    state.width = BATCH_WIDTH;
+    state.height = BATCH_HEIGHT;
+    state.pool = NULL; // the games themselves run in parallel
+    state.settings = (struct GameSettings){ .paddle_has_hitbox = true, .increase_ball_speed = options->increase_ball_speed, .auto_move = controller->auto_move, .event_driven = options->event_driven };
+    state.objects = game_objects_init(arena, BATCH_WIDTH, BATCH_HEIGHT, bricks_hor, bricks_ver, 0, options->paddle_width, BATCH_PADDLE_HEIGHT, options->ball_speed);
+    game_objects_seed(&state.objects, seed);
+
+    struct BatchResult result = { seed, BatchTimeout, 0, 0, 0, options->ball_speed };
+    const float dt = 1.f / options->rate;
+    const uint32_t max_steps = (uint32_t)options->max_seconds * (uint32_t)options->rate;
+    while (result.steps < max_steps && result.outcome == BatchTimeout)
+    {
+        struct InputFrame input = { 0 };
+        if (controller->control != NULL)
+            controller->control(&state, &input);
+
+        // without input the ball flies straight until its next event, the steps up to it are taken at once
+        uint32_t steps = 1;
+        if (controller->control == NULL)
+        {
+            // compared before dividing, FLT_MAX / dt would overflow
+            const float left = (float)(max_steps - result.steps);
+            const float time = game_time_to_event(&state);
+            steps = time >= left * dt ? max_steps - result.steps : (uint32_t)MAX(1.f, floorf(time / dt));
+        }
+
+        struct GameEvents events;
+        game_step(&state, &input, dt * (float)steps, &events);
+        result.steps += steps;
+
+        if (events.flags & EventHitPaddle)
+            result.paddle_hits++;
+        result.peak_speed = MAX(result.peak_speed, state.objects.ball.speed);
+        if (events.flags & EventFailed)
+            result.outcome = BatchFailed;
+        else if (events.flags & EventSuccess)
+            result.outcome = BatchWon;
+    }
+    result.bricks = (uint32_t)state.objects.score;
+    return result;
+}
+
+
+void batch_play_range(void* context, size_t first, size_t last, int worker)
+{
+    const struct BatchContext* batch = context;
+    for (size_t i = first; i < last; ++i)
+    {
+        batch->results[i] = batch_play(batch->options, &batch->arenas[worker], batch->bricks_hor, batch->bricks_ver, batch->options->seed + i);
+    }
+}
+
+
+void batch_write_u32(FILE* file, uint32_t value)
+{
+    const unsigned char bytes[4] = { value & 0xFF, (value >> 8) & 0xFF, (value >> 16) & 0xFF, (value >> 24) & 0xFF };
+    fwrite(bytes, 1, sizeof(bytes), file);
+}
+
+
+// Binary layout, all little endian: "BKBATCH1", u32 game count, then per game
+// u64 seed, u32 outcome (0 failed, 1 won, 2 timeout), u32 steps, u32 paddle hits, u32 bricks, f32 peak speed
+bool batch_write_results(const struct BatchOptions* options, const struct BatchResult* results)
+{
+    FILE* file = fopen(options->out_path, options->binary ? "wb" : "w");
+    if (file == NULL)
+        return false;
+
+    static const char* outcome_names[] = { "failed", "won", "timeout" };
+    if (options->binary)
+    {
+        fwrite("BKBATCH1", 1, 8, file);
+        batch_write_u32(file, (uint32_t)options->games);
+    }
+    else
+    {
+        fprintf(file, "game,seed,outcome,steps,seconds,paddle_hits,bricks,peak_speed\n");
+    }
+
+    for (int i = 0; i < options->games; ++i)
+    {
+        const struct BatchResult* r = &results[i];
+        if (options->binary)
+        {
+            uint32_t speed_bits;
+            memcpy(&speed_bits, &r->peak_speed, sizeof(speed_bits));
+            batch_write_u32(file, (uint32_t)r->seed);
+            batch_write_u32(file, (uint32_t)(r->seed >> 32));
+            batch_write_u32(file, (uint32_t)r->outcome);
+            batch_write_u32(file, r->steps);
+            batch_write_u32(file, r->paddle_hits);
+            batch_write_u32(file, r->bricks);
+            batch_write_u32(file, speed_bits);
+        }
+        else
+        {
+            fprintf(file, "%d,%llu,%s,%u,%.3f,%u,%u,%.1f\n", i, (unsigned long long)r->seed, outcome_names[r->outcome], r->steps, r->steps / (double)options->rate, r->paddle_hits, r->bricks, r->peak_speed);
+        }
+    }
+
+    const bool ok = !ferror(file);
+    return fclose(file) == 0 && ok;
+}
+
+
+bool batch_headless(const struct BatchOptions* options)
+{
+    return options->games > 0 || options->replay_path != NULL;
+}
+
+
+double batch_seconds(void)
+{
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+
+int batch_run(const struct BatchOptions* options, struct ThreadPool* pool, int bricks_hor, int bricks_ver)
+{
+    const int workers = thread_pool_threads(pool);
+    struct Arena arenas[THREAD_POOL_MAX];
+    struct BatchResult* results = malloc(sizeof(struct BatchResult) * (size_t)options->games);
+    bool ok = results != NULL;
+    int initialized = 0;
+    for (; ok && initialized < workers; ++initialized)
+    {
+        // the games never turn on multi ball and no controller spawns balls, so there are no extra ball arrays
+        ok = arena_init(&arenas[initialized], game_objects_level_size(bricks_hor, bricks_ver, 0));
+    }
+
+    if (!ok)
+    {
+        fprintf(stderr, "Failed to allocate memory for %d games\n", options->games);
+    }
+    else
+    {
+        struct BatchContext context = { options, results, arenas, bricks_hor, bricks_ver };
+        const double start = batch_seconds();
+        thread_pool_run(pool, batch_play_range, &context, (size_t)options->games);
+        const double elapsed = batch_seconds() - start;
+
+        size_t outcomes[3] = { 0 };
+        double won_seconds = 0;
+        double paddle_hits = 0;
+        double peak_speed = 0;
+        for (int i = 0; i < options->games; ++i)
+        {
+            outcomes[results[i].outcome]++;
+            paddle_hits += results[i].paddle_hits;
+            peak_speed += results[i].peak_speed;
+            if (results[i].outcome == BatchWon)
+                won_seconds += results[i].steps / (double)options->rate;
+        }
+
+        printf("%d games (%s controller, %d threads) in %.2f s, %.0f games per minute\n", options->games, sg_Controllers[options->controller].name, workers, elapsed, options->games / MAX(elapsed, 1e-9) * 60);
+        printf("won %.2f %%, failed %.2f %%, timeout %.2f %%\n", outcomes[BatchWon] * 100.0 / options->games, outcomes[BatchFailed] * 100.0 / options->games, outcomes[BatchTimeout] * 100.0 / options->games);
+        printf("mean time to clear %.2f s, mean paddle hits %.1f, mean peak speed %.1f\n", won_seconds / MAX(outcomes[BatchWon], 1), paddle_hits / options->games, peak_speed / options->games);
+
+        if (options->out_path != NULL && !batch_write_results(options, results))
+        {
+            fprintf(stderr, "Failed to write %s\n", options->out_path);
+            ok = false;
+        }
+    }
+
+    for (int i = 0; i < initialized; ++i)
+        arena_free(&arenas[i]);
+    free(results);
+    return ok ? 0 : 1;
+}
+
+
+int batch_compare_seconds(const void* a, const void* b)
+{
+    const float x = *(const float*)a;
+    const float y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+
+
+// FNV-1a over everything a different build could get wrong, equal hashes mean both builds played the same game
+uint64_t batch_state_hash(const struct GameState* state)
+{
+    const struct GameObjects* objects = &state->objects;
+    const float values[] = { objects->ball.center.x, objects->ball.center.y, objects->ball.direction.x, objects->ball.direction.y, objects->ball.speed, objects->paddle.x };
+    const uint64_t counts[] = { objects->score, objects->extra_balls.count };
+
+    uint64_t hash = 14695981039346656037ULL;
+    const unsigned char* bytes[] = { (const unsigned char*)values, (const unsigned char*)counts, (const unsigned char*)objects->bricks.alive };
+    const size_t sizes[] = { sizeof(values), sizeof(counts), BITSET_WORDS(objects->bricks.count) * sizeof(uint64_t) };
+    for (size_t i = 0; i < ARRAY_SIZE(bytes); ++i)
+    {
+        for (size_t b = 0; b < sizes[i]; ++b)
+            hash = (hash ^ bytes[i][b]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+
+int batch_replay(const char* path, struct ThreadPool* pool)
+{
+    struct Replay replay;
+    if (!replay_load(&replay, path))
+    {
+        fprintf(stderr, "Failed to load the replay %s\n", path);
+        return 1;
+    }
+
+    const struct ReplayHeader* header = &replay.header;
+    const int width = (int)header->width;
+    const int height = (int)header->height;
+    struct Arena arena;
+    float* costs = malloc(sizeof(float) * replay.size); // every step takes at least one byte
+    if (costs == NULL || !arena_init(&arena, game_objects_level_size(header->bricks_hor, header->bricks_ver, EXTRA_BALLS_MAX)))
+    {
+        fprintf(stderr, "Failed to allocate memory for the replay %s\n", path);
+        free(costs);
+        replay_free(&replay);
+        return 1;
+    }
+
+    struct GameState state = { 0 };
+    state.width = header->width;
+    state.height = header->height;
+    state.pool = pool;
+    state.settings = game_settings_unpack(header->settings);
+    state.objects = game_objects_init(&arena, width, height, header->bricks_hor, header->bricks_ver, EXTRA_BALLS_MAX, header->paddle_width, header->paddle_height, header->ball_speed);
+    game_objects_seed(&state.objects, header->seed);
+
+    const float dt = 1.f / header->rate;
+    size_t steps = 0;
+    size_t resets = 0;
+    double total = 0;
+    struct InputFrame input;
+    float speed;
+    for (enum ReplayItem item; (item = replay_next(&replay, &state, &input, &speed)) != ReplayEnd;)
+    {
+        if (item == ReplayReset)
+        {
+            state.objects = game_objects_init(&arena, width, height, header->bricks_hor, header->bricks_ver, EXTRA_BALLS_MAX, header->paddle_width, header->paddle_height, speed);
+            game_objects_seed(&state.objects, header->seed);
+            resets++;
+            continue;
+        }
+
+        struct GameEvents events;
+        const double start = batch_seconds();
+        game_step(&state, &input, dt, &events);
+        const double cost = batch_seconds() - start;
+        costs[steps++] = (float)cost;
+        total += cost;
+    }
+
+    if (steps > 0)
+    {
+        qsort(costs, steps, sizeof(float), batch_compare_seconds);
+        const double game_seconds = steps / (double)header->rate;
+        printf("%zu steps (%.2f s of game time, %zu resets) in %.3f s, %.1fx real time\n", steps, game_seconds, resets, total, game_seconds / MAX(total, 1e-9));
+        printf("step cost mean %.2f us, p50 %.2f us, p99 %.2f us, max %.2f us\n", total / steps * 1e6, costs[steps / 2] * 1e6, costs[MIN(steps - 1, steps * 99 / 100)] * 1e6, costs[steps - 1] * 1e6);
+    }
+    printf("final state: score %zu, ball (%.3f, %.3f), hash %016llx\n", state.objects.score, state.objects.ball.center.x, state.objects.ball.center.y, (unsigned long long)batch_state_hash(&state));
+
+    arena_free(&arena);
+    free(costs);
+    replay_free(&replay);
+    return 0;
+}
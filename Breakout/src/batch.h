@@ -0,0 +1,38 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdbool.h>
+
+#include "simulation.h"
+
+/*
+    Headless Monte Carlo runner, plays many seeded games without a window to evaluate
+    balance changes (ball speed, paddle width, speed increase...) statistically.
+    Game i uses the seed seed + i, so any game of a run can be reproduced on its own.
+*/
+struct BatchOptions
+{
+    int games; // 0 starts the game as usual
+    unsigned long long seed;
+    const char* out_path; // per game stats, NULL only prints the summary
+    bool binary;
+    int controller;
+    float ball_speed;
+    int paddle_width;
+    bool increase_ball_speed;
+    bool event_driven;
+    int rate;        // simulation steps per second
+    int max_seconds; // of game time, longer games are counted as timeouts
+    const char* replay_path; // plays a recording from --record back instead of running games
+};
+
+
+struct BatchOptions batch_default_options(void);
+bool batch_parse_arg(struct BatchOptions* options, int argc, char** argv, int* i); // false if argv[*i] isn't a batch option
+bool batch_headless(const struct BatchOptions* options); // true if the options don't need a window
+int batch_run(const struct BatchOptions* options, struct ThreadPool* pool, int bricks_hor, int bricks_ver);
+// Plays a recording as fast as possible and prints the cost per step and a hash of the final state,
+// the same recording against two builds compares their performance
+int batch_replay(const char* path, struct ThreadPool* pool);
+
+#endif // BATCH_H
@@ -0,0 +1,141 @@
+#include <stdlib.h>
+
+#include "brick_layer.h"
+#include "rlgl.h" // after raylib.h, it shares its types
+
+#define BRICK_LAYER_CHUNK 256 // bricks gathered before they are submitted at once
+
+
+// Bricks waiting to be submitted with one DrawRectanglesBatch()
+struct BrickChunk
+{
+    Rectangle recs[BRICK_LAYER_CHUNK];
+    Color colors[BRICK_LAYER_CHUNK];
+    int count;
+};
+
+
+void brick_layer_init(struct BrickLayer* layer, int width, int height)
+{
+    layer->target = LoadRenderTexture(width, height);
+    layer->drawn = NULL;
+    layer->capacity = 0;
+    layer->count = 0;
+    layer->valid = false;
+}
+
+
+void brick_layer_free(struct BrickLayer* layer)
+{
+    UnloadRenderTexture(layer->target);
+    free(layer->drawn);
+    layer->drawn = NULL;
+    layer->capacity = 0;
+}
+
+
+void brick_layer_resize(struct BrickLayer* layer, int width, int height)
+{
+    UnloadRenderTexture(layer->target);
+    layer->target = LoadRenderTexture(width, height);
+    layer->valid = false;
+}
+
+
+void brick_chunk_flush(struct BrickChunk* chunk)
+{
+    DrawRectanglesBatch(chunk->recs, chunk->colors, chunk->count);
+    chunk->count = 0;
+}
+
+
+void brick_chunk_add(struct BrickChunk* chunk, const struct Bricks* bricks, size_t i, Color color)
+{
+    chunk->recs[chunk->count] = (Rectangle){ bricks->x[i], bricks->y[i], bricks->width[i], bricks->height[i] };
+    chunk->colors[chunk->count] = color;
+    if (++chunk->count == BRICK_LAYER_CHUNK)
+        brick_chunk_flush(chunk);
+}
+
+
+// True if every brick in the texture is still alive and the texture can be patched instead of redrawn
+bool brick_layer_patchable(const struct BrickLayer* layer, const struct Bricks* bricks)
+{
+    if (!layer->valid || layer->count != bricks->count)
+        return false;
+
+    for (size_t w = 0; w < BITSET_WORDS(bricks->count); ++w)
+    {
+        if (bricks->alive[w] & ~layer->drawn[w])
+            return false;
+    }
+    return true;
+}
+
+
+void brick_layer_update(struct BrickLayer* layer, const struct Bricks* bricks)
+{
+    const size_t words = BITSET_WORDS(bricks->count);
+    if (bricks->count > layer->capacity)
+    {
+        uint64_t* drawn = realloc(layer->drawn, words * sizeof(uint64_t));
+        if (drawn == NULL)
+            return;
+        layer->drawn = drawn;
+        layer->capacity = words * 64;
+        layer->valid = false;
+    }
+
+    const bool patch = brick_layer_patchable(layer, bricks);
+    if (patch)
+    {
+        size_t w = 0;
+        while (w < words && bricks->alive[w] == layer->drawn[w])
+            ++w;
+        if (w == words)
+            return; // nothing was hit since the last frame
+    }
+
+    // bricks don't overlap, overwriting the texels keeps their color exactly as drawn straight to the screen
+    // and lets the erased ones become transparent again
+    struct BrickChunk chunk;
+    chunk.count = 0;
+    BeginTextureMode(layer->target);
+    rlSetBlendFactors(RL_ONE, RL_ZERO, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM);
+    if (patch)
+    {
+        for (size_t w = 0; w < words; ++w)
+        {
+            uint64_t hit = layer->drawn[w] & ~bricks->alive[w];
+            while (hit != 0)
+            {
+                brick_chunk_add(&chunk, bricks, w * 64 + (size_t)count_trailing_zeros(hit), BLANK);
+                hit &= hit - 1;
+            }
+        }
+    }
+    else
+    {
+        ClearBackground(BLANK);
+        BRICKS_FOR_EACH_ALIVE(bricks, i) {
+            brick_chunk_add(&chunk, bricks, i, bricks->color[i]);
+        }
+    }
+    brick_chunk_flush(&chunk);
+    EndBlendMode();
+    EndTextureMode();
+
+    for (size_t w = 0; w < words; ++w)
+        layer->drawn[w] = bricks->alive[w];
+    layer->count = bricks->count;
+    layer->valid = true;
+}
+
+
+void brick_layer_draw(const struct BrickLayer* layer)
+{
+    const Texture2D* texture = &layer->target.texture;
+    // render textures are upside down
+    DrawTextureRec(*texture, (Rectangle){ 0.f, 0.f, (float)texture->width, (float)-texture->height }, (Vector2){ 0.f, 0.f }, WHITE);
+}
@@ -0,0 +1,32 @@
+#ifndef BRICK_LAYER_H
+#define BRICK_LAYER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "raylib.h"
+#include "simulation.h"
+
+/*
+    The bricks only change when one is hit, so they are kept in a texture of the window's size
+    and composited with a single quad. Every frame the alive bits are compared to the ones in
+    the texture, a hit brick is erased on its own, a new level redraws the whole field.
+*/
+struct BrickLayer
+{
+    RenderTexture2D target;
+    uint64_t* drawn;  // alive bits of the bricks in the texture
+    size_t capacity;  // bricks drawn has room for
+    size_t count;     // bricks in the texture
+    bool valid;       // false redraws every brick with the next update
+};
+
+
+void brick_layer_init(struct BrickLayer* layer, int width, int height);
+void brick_layer_free(struct BrickLayer* layer);
+void brick_layer_resize(struct BrickLayer* layer, int width, int height); // the bricks moved, the layer is redrawn
+void brick_layer_update(struct BrickLayer* layer, const struct Bricks* bricks);
+void brick_layer_draw(const struct BrickLayer* layer);
+
+#endif // BRICK_LAYER_H
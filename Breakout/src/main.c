@@ -1,7 +1,18 @@
 ﻿#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <stdbool.h>
 
 #include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h" // after raylib.h, it shares its types
+#include "rtrace.h"
+#include "simulation.h"
+#include "batch.h"
+#include "replay.h"
+#include "profiler.h"
+#include "actions.h"
+#include "brick_layer.h"
 
 #include "sounds.h"
 #include "images.h"
@@ -11,16 +22,17 @@
     #include <emscripten/emscripten.h>
 #endif
 
-#define BRICKS_HOR     10 // num of horizontal bricks
-#define BRICKS_VER     7  // num of vertical bricks
-#define NUM_BRICKS     BRICKS_HOR * BRICKS_VER
-#define BRICK_PADDING  5
-#define BRICK_Y_OFFSET 60
-
 #define MIN(a, b) (a < b ? a : b)
 #define MAX(a, b) (a > b ? a : b)
 #define ARRAY_SIZE(a) (sizeof(a) / sizeof(*a))
-#define KEY_REPEAT(key) (IsKeyPressed(key) || IsKeyPressedRepeat(key))
+#define PROFILE(profiler, phase, call) do { RL_ZONE_BEGIN(#phase); const double profile_start = GetTime(); call; profiler_add(profiler, phase, GetTime() - profile_start); RL_ZONE_END(); } while (0)
+#define TRACE_FILE "breakout_trace.json" // only written when built with --trace
+
+#define SIM_DEFAULT_RATE       240 // simulation steps per second, independent of the frame rate
+#define SIM_MAX_CATCH_UP_STEPS 16  // steps per frame before the remaining time is dropped
+#define STEP_ACTIONS ((1ull << ActionMoveLeft) | (1ull << ActionMoveRight) | (1ull << ActionSpawnBalls)) // applied by the simulation steps, the others once per frame
+
+#define EXTRA_BALL_SIDES 12 // there can be thousands of them, a polygon is close enough
 
 
 enum State
@@ -36,52 +48,6 @@ enum State
 };
 
 
-struct Brick
-{
-    Rectangle rec;
-    Color col;
-};
-
-
-struct Tail
-{
-    Vector2 p1;
-    Vector2 p2;
-    Vector2 p3;
-};
-
-
-struct Ball
-{
-    Vector2 center;
-    float radius;
-    float speed;
-    Vector2 direction;
-    Vector2 prev_direction;
-    struct Tail tail;
-};
-
-
-struct GameObjects
-{
-    struct Brick bricks[NUM_BRICKS];
-    Rectangle paddle;
-    struct Ball ball;
-    size_t score;
-};
-
-
-struct GameSettings
-{
-    bool make_bottom_hitbox;
-    bool paddle_has_hitbox;
-    bool show_stats;
-    bool increase_ball_speed;
-    bool auto_restart;
-    bool auto_move;
-};
-
-
 struct ToggleSound
 {
     Sound sound;
@@ -99,23 +65,47 @@ struct SoundObjects
 };
 
 
+struct FixedTimestep
+{
+    float step;
+    float accumulator;
+    float alpha; // where the rendered frame lies between the previous and the current step
+    int max_steps;
+    struct Ball prev_ball;
+    Rectangle prev_paddle;
+};
+
+
 struct Application
 {
-    struct GameObjects game_objects;
-    struct GameSettings game_settings;
+    struct GameState game;
+    struct Arena level_arena;
+    struct FixedTimestep timestep;
     struct SoundObjects sound_objects;
     enum State state;
+    enum State last_state; // at the start of the last frame
     int width;
     int height;
     int frame_rate;
     int font_size_menu;
+    int bricks_hor;
+    int bricks_ver;
+    int threads;
+    struct BatchOptions batch;
+    struct Replay replay;
+    const char* record_path; // NULL if the session isn't recorded
+    struct Profiler profiler;
+    struct Actions actions; // sampled once at the start of every frame
+    uint64_t latency_pending; // bit per Action, started actions the steps apply that no step has applied yet
     size_t wins;
     size_t failes;
     bool x_ray;
     bool show_fps;
+    bool show_profiler;
     bool limit_fps;
     Texture2D volume_on;
     Texture2D volume_off;
+    struct BrickLayer brick_layer; // the bricks of the last frame, game_render() patches and composites it
 };
 
 
@@ -131,34 +121,6 @@ float min_3(float a, float b, float c)
 }
 
 
-void generate_bricks(struct Brick* bricks, int window_width, int paddle_height)
-{
-    const float brick_width = window_width / (float)BRICKS_HOR - BRICK_PADDING*2;
-
-    size_t color_idx = 0;
-    const Color colors[BRICKS_VER] = { RED, ORANGE, YELLOW, GREEN, BLUE, PURPLE, SKYBLUE };
-
-    float current_x = BRICK_PADDING;
-    float current_y = BRICK_Y_OFFSET;
-    for (size_t i = 0; i < NUM_BRICKS; ++i)
-    {
-        bricks[i].rec.x = current_x;
-        bricks[i].rec.y = current_y;
-        bricks[i].rec.width = brick_width;
-        bricks[i].rec.height = paddle_height;
-        bricks[i].col = colors[color_idx];
-        current_x += brick_width + BRICK_PADDING*2;
-
-        if ((i + 1) % BRICKS_HOR == 0)
-        {
-            current_x = BRICK_PADDING;
-            current_y += paddle_height + 5;
-            color_idx++;
-        }
-    }
-}
-
-
 void play_sound(struct ToggleSound sound)
 {
     if (!sound.play) return;
@@ -175,231 +137,122 @@ void play_sound(struct ToggleSound sound)
 }
 
 
-void tail_set_vertical_collision(struct Ball* ball, int from_above)
-{
-    const float radius = from_above ? ball->radius : -ball->radius;
-    ball->tail.p3.x = (ball->tail.p1.x + ball->tail.p2.x) / 2.f;
-    ball->tail.p3.y = (ball->tail.p1.y + ball->tail.p2.y) / 2.f;
-
-    ball->tail.p1.x = ball->center.x - ball->radius * 0.5f;
-    ball->tail.p1.y = ball->center.y + radius;
-
-    ball->tail.p2.x = ball->center.x + ball->radius * 0.5f;
-    ball->tail.p2.y = ball->center.y + radius;
-}
-
-
-void tail_set_horizontal_collision(struct Ball* ball, int right_wall)
+struct FixedTimestep fixed_timestep_init(int rate, int max_steps)
 {
-    const float radius = right_wall ? ball->radius : -ball->radius;
-    ball->tail.p3.x = (ball->tail.p1.x + ball->tail.p2.x) / 2.f;
-    ball->tail.p3.y = (ball->tail.p1.y + ball->tail.p2.y) / 2.f;
-
-    ball->tail.p1.x = ball->center.x + radius;
-    ball->tail.p1.y = ball->center.y - ball->radius * 0.5f;
-
-    ball->tail.p2.x = ball->center.x + radius;
-    ball->tail.p2.y = ball->center.y + ball->radius * 0.5f;
+    struct FixedTimestep timestep = { 0 };
+    timestep.step = 1.f / rate;
+    timestep.max_steps = max_steps;
+    return timestep;
 }
 
 
-Vector2 ball_calculate_reflected_direction(Vector2 normal, Vector2 current_direction)
+// Forget the previous step, used whenever the objects are moved outside of the simulation
+void fixed_timestep_snap(struct FixedTimestep* timestep, const struct GameObjects* objects)
 {
-    const float dot_product = current_direction.x * normal.x + current_direction.y * normal.y;
-
-    Vector2 reflected_direction;
-    reflected_direction.x = current_direction.x - 2.0f * dot_product * normal.x;
-    reflected_direction.y = current_direction.y - 2.0f * dot_product * normal.y;
-    return reflected_direction;
+    timestep->prev_ball = objects->ball;
+    timestep->prev_paddle = objects->paddle;
 }
 
 
-bool ball_bricks_collision(struct Ball* ball, struct Brick* bricks)
+enum State on_game_update(struct Application* app, float frame_time)
 {
-    for (size_t i = 0; i < NUM_BRICKS; ++i)
-    {
-        if (bricks[i].rec.x > 0 && CheckCollisionCircleRec(ball->center, ball->radius, bricks[i].rec))
-        {
-            bricks[i].rec.x = -20;
-            bricks[i].rec.y = -20;
-            bricks[i].rec.width = 0;
-
-            ball->prev_direction = ball->direction;
-            tail_set_vertical_collision(ball, ball->direction.y > 0);
-            ball->direction = ball_calculate_reflected_direction((Vector2) { 0, 1 }, ball->direction);
-            return true;
-        }
-    }
-    return false;
-}
-
+    static float prev_mouse_pos = 0.f;
+    const struct Actions* actions = &app->actions;
 
-void ball_move_tail_tip(struct Ball* ball, float speed, float dt)
-{
-    ball->tail.p3.x += ball->prev_direction.x * dt * speed;
-    ball->tail.p3.y += ball->prev_direction.y * dt * speed;
-}
+    if (action_active(actions, ActionResetAll))
+        return ResetAll;
 
+    if (action_active(actions, ActionReset))
+        return Reset;
 
-void ball_animate_tail(struct Ball* ball, float dt)
-{
-    static const float speed_multiply = 0.9f;
-    const float speed = ball->speed * speed_multiply;
+    if (action_active(actions, ActionPause))
+        return Break;
 
-    // p1 is left p2 is right
-    // if from upper left to lower right
-    if ((ball->prev_direction.y > 0 && ball->prev_direction.x > 0)
-        && ((ball->tail.p1.x == ball->tail.p2.x && ball->tail.p3.x < ball->tail.p1.x)
-            || (ball->tail.p1.y == ball->tail.p2.y && ball->tail.p3.y < ball->tail.p1.y))
-        )
-    {
-        ball_move_tail_tip(ball, speed, dt);
-    }
-    // if from lower left to upper right
-    else if ((ball->prev_direction.x > 0 && ball->prev_direction.y < 0)
-        && ((ball->tail.p1.x == ball->tail.p2.x && ball->tail.p3.x < ball->tail.p1.x)
-            || (ball->tail.p1.y == ball->tail.p2.y && ball->tail.p3.y > ball->tail.p1.y))
-        )
+    struct InputFrame input = { 0 };
+    if (action_active(actions, ActionSpawnBalls))
     {
-        ball_move_tail_tip(ball, speed, dt);
+        input.actions |= InputSpawnBalls;
     }
-    // if from upper right to lower left
-    else if ((ball->prev_direction.x < 0 && ball->prev_direction.y > 0)
-        && ((ball->tail.p1.x == ball->tail.p2.x && ball->tail.p3.x > ball->tail.p1.x)
-            || (ball->tail.p1.y == ball->tail.p2.y && ball->tail.p3.y < ball->tail.p1.y))
-        )
-    {
-        ball_move_tail_tip(ball, speed, dt);
-    }
-    // if from lower right to upper left
-    else if ((ball->prev_direction.x < 0 && ball->prev_direction.y < 0)
-        && ((ball->tail.p1.x == ball->tail.p2.x && ball->tail.p3.x > ball->tail.p1.x)
-            || (ball->tail.p1.y == ball->tail.p2.y && ball->tail.p3.y > ball->tail.p1.y))
-        )
-    {
-        ball_move_tail_tip(ball, speed, dt);
-    }
-    else
-    {
-        ball->tail.p3.x = (ball->tail.p1.x + ball->tail.p2.x) / 2.f;
-        ball->tail.p3.y = (ball->tail.p1.y + ball->tail.p2.y) / 2.f;
-    }
-}
-
-
-bool ball_move(struct Ball* ball, Rectangle paddle, Vector2 window_size, float dt, struct ToggleSound hit_sound, struct GameSettings settings)
-{
-    ball->center.x += ball->direction.x * dt * ball->speed;
-    ball->center.y += ball->direction.y * dt * ball->speed;
 
-    static const Vector2 normal_hor = { .x = 1, .y = 0 };
-    static const Vector2 normal_ver = { .x = 0, .y = 1 };
+    // actions started in another state than the game never reach a step
+    if (app->last_state != Game)
+        app->latency_pending = 0;
+    app->latency_pending |= actions->started & STEP_ACTIONS;
 
-    ball_animate_tail(ball, dt);
+    struct FixedTimestep* timestep = &app->timestep;
+    timestep->accumulator += frame_time;
 
-    if ((ball->center.x + ball->radius >= window_size.x && ball->direction.x > 0) || (ball->center.x - ball->radius <= 0 && ball->direction.x < 0))
-    {
-        ball->prev_direction = ball->direction;
-        tail_set_horizontal_collision(ball, ball->direction.x > 0);
-        ball->direction = ball_calculate_reflected_direction(normal_hor, ball->direction);
-    }
-    else if ((ball->center.y - ball->radius <= 0 && ball->direction.y < 0) || (settings.make_bottom_hitbox && ball->center.y + ball->radius >= window_size.y && ball->direction.y > 0))
-    {
-        ball->prev_direction = ball->direction;
-        tail_set_vertical_collision(ball, ball->direction.y > 0);
-        ball->direction = ball_calculate_reflected_direction(normal_ver, ball->direction);
-    }
-    else if (settings.paddle_has_hitbox && CheckCollisionCircleRec(ball->center, ball->radius, paddle) && ball->direction.y > 0)
+    unsigned int frame_events = 0;
+    int steps = 0;
+    while (timestep->accumulator >= timestep->step && steps < timestep->max_steps && !(frame_events & (EventFailed | EventSuccess)))
     {
-        ball->prev_direction = ball->direction;
-        tail_set_vertical_collision(ball, ball->direction.y > 0);
-        // if you hit the ball in the first 25 % the ball goes back the direction reverses
-        // if going from left to right                                                    if going from right to left
-        if ((ball->direction.x > 0 && ball->center.x < paddle.x + paddle.width * 0.25) || (ball->direction.x < 0 && ball->center.x > paddle.x + paddle.width * 0.75))
+        // the steps catch up with the time since the last frame, each one gets the input of its own point in it
+        const struct ActionState state = actions_at(actions, actions->time - (timestep->accumulator - timestep->step));
+        input.actions &= ~(unsigned int)(InputMoveLeft | InputMoveRight | InputMouseMoved);
+        if (action_held(&state, ActionMoveLeft))
         {
-            ball->direction.x = -ball->direction.x;
-            ball->direction.y = -ball->direction.y;
+            input.actions |= InputMoveLeft;
         }
-        else
+
+        if (action_held(&state, ActionMoveRight))
         {
-            ball->direction = ball_calculate_reflected_direction(normal_ver, ball->direction);
+            input.actions |= InputMoveRight;
         }
-        play_sound(hit_sound);
-    }
-    else if (!settings.make_bottom_hitbox && ball->center.y + ball->radius >= window_size.y)
-        return false;
-    return true;
-}
-
 
-struct GameObjects game_objects_init(int window_width, int window_height, int paddle_width, int paddle_height, float ball_speed /* we dont want to reset the ball speed */)
-{
-    struct GameObjects objects;
-    objects.score = 0;
-    objects.paddle = (Rectangle) { (window_width - paddle_width) / 2.f, window_height - 60, paddle_width, paddle_height };
-    objects.ball = (struct Ball){ { objects.paddle.x + paddle_width / 2.f, objects.paddle.y - 20 }, 15.f, ball_speed, { 1.4f, -1 }, { 0, 0 } };
-    objects.ball.tail.p1 = (Vector2) { objects.ball.center.x - 7.f, objects.paddle.y };
-    objects.ball.tail.p2 = (Vector2){ objects.ball.center.x + 7.f, objects.paddle.y };
-    objects.ball.tail.p3 = (Vector2) { objects.paddle.x + paddle_width / 2.f, objects.paddle.y };
-    generate_bricks(objects.bricks, window_width, paddle_height);
-    return objects;
-}
-
-
-enum State on_game_update(struct Application* app, float dt)
-{
-    static float prev_mouse_pos = 0.f;
+        if (prev_mouse_pos != state.mouse.x)
+        {
+            input.actions |= InputMouseMoved;
+            input.mouse_x = state.mouse.x;
+            prev_mouse_pos = state.mouse.x;
+        }
 
-    if (IsKeyPressed(KEY_L))
-        return ResetAll;
+        fixed_timestep_snap(timestep, &app->game.objects);
 
-    if (IsKeyPressed(KEY_R) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_RIGHT_FACE_UP))
-        return Reset;
+        struct GameEvents events;
+        if (app->record_path != NULL)
+            replay_record_step(&app->replay, &app->game, &input);
+        game_step(&app->game, &input, timestep->step, &events);
+        if (app->record_path != NULL)
+            replay_record_end_step(&app->replay, &app->game);
+        frame_events |= events.flags;
+        input.actions &= ~(unsigned int)InputSpawnBalls; // once per key press, not per step
 
-    if (IsKeyPressed(KEY_ESCAPE) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_RIGHT_FACE_DOWN) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_MIDDLE_RIGHT))
-        return Break;
-
-    if (IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT) || IsGamepadButtonDown(0, GAMEPAD_BUTTON_LEFT_FACE_LEFT) || GetGamepadAxisMovement(0, GAMEPAD_AXIS_LEFT_X) < 0)
-    {
-        app->game_objects.paddle.x = MAX(0, app->game_objects.paddle.x - 1250 * dt);
+        timestep->accumulator -= timestep->step;
+        steps++;
     }
 
-    if (IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT) || IsGamepadButtonDown(0, GAMEPAD_BUTTON_LEFT_FACE_RIGHT) || GetGamepadAxisMovement(0, GAMEPAD_AXIS_LEFT_X) > 0)
+    // the input latency of the profiler, from an action's input to the steps that applied it
+    if (steps > 0 && app->latency_pending != 0)
     {
-        app->game_objects.paddle.x = MIN(app->game_objects.paddle.x + 1250 * dt, app->width - app->game_objects.paddle.width);
+        const double now = GetTime();
+        for (int action = 0; action < ActionCount; ++action)
+        {
+            if ((app->latency_pending >> action) & 1)
+                profiler_add_latency(&app->profiler, now - actions->since[action]);
+        }
+        app->latency_pending = 0;
     }
 
-    const float mouse_pos = GetMousePosition().x;
-    if (prev_mouse_pos != mouse_pos)
-    {
-        app->game_objects.paddle.x = mouse_pos - app->game_objects.paddle.width / 2;
-        app->game_objects.paddle.x = MIN(app->game_objects.paddle.x, app->width - app->game_objects.paddle.width);
-        app->game_objects.paddle.x = MAX(0, app->game_objects.paddle.x);
-        prev_mouse_pos = mouse_pos;
-    }
+    // either the game is over or we couldn't keep up, in the latter case the game
+    // slows down instead of spiraling further behind
+    if (timestep->accumulator >= timestep->step)
+        timestep->accumulator = 0.f;
+    timestep->alpha = timestep->accumulator / timestep->step;
+
+    if (frame_events & EventHitPaddle)
+        play_sound(app->sound_objects.hit_paddle);
 
-    if (!ball_move(&app->game_objects.ball, app->game_objects.paddle, (Vector2){ app->width, app->height }, dt, app->sound_objects.hit_paddle, app->game_settings))
+    if (frame_events & EventFailed)
     {
         app->failes++;
         play_sound(app->sound_objects.failed);
         return Failed;
     }
 
-    if (app->game_settings.auto_move)
-    {
-        app->game_objects.paddle.x = app->game_objects.ball.center.x - app->game_objects.paddle.width / 2.f;
-        app->game_objects.paddle.x = MIN(app->game_objects.paddle.x, app->width - app->game_objects.paddle.width);
-        app->game_objects.paddle.x = MAX(0, app->game_objects.paddle.x);
-    }
-
-    if (ball_bricks_collision(&app->game_objects.ball, app->game_objects.bricks))
-    {
+    if (frame_events & EventHitBrick)
         play_sound(app->sound_objects.hit_brick);
-        app->game_objects.score++;
-        if (app->game_settings.increase_ball_speed)
-            app->game_objects.ball.speed += 6.f;
-    }
-    if (app->game_objects.score == NUM_BRICKS)
+
+    if (frame_events & EventSuccess)
     {
         app->wins++;
         play_sound(app->sound_objects.success);
@@ -484,41 +337,68 @@ void draw_triangle(Vector2 p1, Vector2 p2, Vector2 p3, Color color)
 }
 
 
-void game_render(const struct GameObjects* game_objects, Vector2 ball_p1, Vector2 ball_p2, Color tail_color)
+void game_render(const struct GameObjects* game_objects, struct BrickLayer* brick_layer, const struct Ball* ball, Rectangle paddle, Vector2 ball_p1, Vector2 ball_p2, Color tail_color)
 {
-    draw_triangle(game_objects->ball.tail.p1, game_objects->ball.tail.p2, ball_p1, tail_color);
-    draw_triangle(ball_p1, ball_p2, game_objects->ball.tail.p2, tail_color);
-    draw_triangle(game_objects->ball.tail.p1, game_objects->ball.tail.p2, game_objects->ball.tail.p3, tail_color);
+    draw_triangle(ball->tail.p1, ball->tail.p2, ball_p1, tail_color);
+    draw_triangle(ball_p1, ball_p2, ball->tail.p2, tail_color);
+    draw_triangle(ball->tail.p1, ball->tail.p2, ball->tail.p3, tail_color);
 
-    DrawRectangleRec(game_objects->paddle, RED);
-    DrawCircleV(game_objects->ball.center, game_objects->ball.radius, LIGHTGRAY);
+    DrawRectangleRec(paddle, RED);
+    DrawCircleV(ball->center, ball->radius, LIGHTGRAY);
 
-    for (size_t i = 0; i < NUM_BRICKS; ++i) {
-        DrawRectangleRec(game_objects->bricks[i].rec, game_objects->bricks[i].col);
+    brick_layer_update(brick_layer, &game_objects->bricks);
+    brick_layer_draw(brick_layer);
+
+    // extra balls aren't interpolated, they are drawn where the last step left them
+    const struct ExtraBalls* balls = &game_objects->extra_balls;
+    for (size_t i = 0; i < balls->count; ++i) {
+        DrawPoly((Vector2){ balls->x[i], balls->y[i] }, EXTRA_BALL_SIDES, ball->radius, 0, LIGHTGRAY);
     }
 }
 
 
-void game_render_xray(const struct GameObjects* game_objects, Vector2 ball_p1, Vector2 ball_p2, Color tail_color)
+void game_render_xray(const struct GameObjects* game_objects, const struct Ball* ball, Rectangle paddle, Vector2 ball_p1, Vector2 ball_p2, Color tail_color)
 {
-    DrawLineV(ball_p1, game_objects->ball.tail.p1, tail_color);
-    DrawLineV(ball_p2, game_objects->ball.tail.p2, tail_color);
-    DrawLineV(game_objects->ball.tail.p1, game_objects->ball.tail.p3, tail_color);
-    DrawLineV(game_objects->ball.tail.p2, game_objects->ball.tail.p3, tail_color);
+    DrawLineV(ball_p1, ball->tail.p1, tail_color);
+    DrawLineV(ball_p2, ball->tail.p2, tail_color);
+    DrawLineV(ball->tail.p1, ball->tail.p3, tail_color);
+    DrawLineV(ball->tail.p2, ball->tail.p3, tail_color);
+
+    DrawRectangleLinesEx(paddle, 1.f, RED);
+    DrawCircleLinesV(ball->center, ball->radius, LIGHTGRAY);
 
-    DrawRectangleLinesEx(game_objects->paddle, 1.f, RED);
-    DrawCircleLinesV(game_objects->ball.center, game_objects->ball.radius, LIGHTGRAY);
+    const struct Bricks* bricks = &game_objects->bricks;
+    BRICKS_FOR_EACH_ALIVE(bricks, i) {
+        DrawRectangleLinesEx((Rectangle){ bricks->x[i], bricks->y[i], bricks->width[i], bricks->height[i] }, 1.f, bricks->color[i]);
+    }
 
-    for (size_t i = 0; i < NUM_BRICKS; ++i) {
-        DrawRectangleLinesEx(game_objects->bricks[i].rec, 1.f, game_objects->bricks[i].col);
+    const struct ExtraBalls* balls = &game_objects->extra_balls;
+    for (size_t i = 0; i < balls->count; ++i) {
+        DrawPolyLines((Vector2){ balls->x[i], balls->y[i] }, EXTRA_BALL_SIDES, ball->radius, 0, LIGHTGRAY);
     }
 }
 
 
-void on_game_render(const struct Application* app)
+struct Ball ball_interpolate(const struct Ball* prev, const struct Ball* current, float alpha)
+{
+    struct Ball ball = *current;
+    ball.center = Vector2Lerp(prev->center, current->center, alpha);
+    ball.tail.p1 = Vector2Lerp(prev->tail.p1, current->tail.p1, alpha);
+    ball.tail.p2 = Vector2Lerp(prev->tail.p2, current->tail.p2, alpha);
+    ball.tail.p3 = Vector2Lerp(prev->tail.p3, current->tail.p3, alpha);
+    return ball;
+}
+
+
+void on_game_render(struct Application* app)
 {
-    const struct Ball* ball = &app->game_objects.ball;
-    const struct Tail* tail = &app->game_objects.ball.tail;
+    // the simulation runs ahead of the frame, draw the moving objects between the last two steps
+    const struct Ball interpolated_ball = ball_interpolate(&app->timestep.prev_ball, &app->game.objects.ball, app->timestep.alpha);
+    Rectangle paddle = app->game.objects.paddle;
+    paddle.x = Lerp(app->timestep.prev_paddle.x, paddle.x, app->timestep.alpha);
+
+    const struct Ball* ball = &interpolated_ball;
+    const struct Tail* tail = &interpolated_ball.tail;
 
     Vector2 ball_p1 = { .x = ball->center.x, .y = ball->center.y - ball->radius };
     Vector2 ball_p2 = { .x = ball->center.x, .y = ball->center.y + ball->radius };
@@ -532,25 +412,25 @@ void on_game_render(const struct Application* app)
     }
 
     static const int score_font_size = 45;
-    const char* score_str = TextFormat("%zu", app->game_objects.score);
+    const char* score_str = TextFormat("%zu", app->game.objects.score);
     const int text_length = MeasureText(score_str, score_font_size);
     const int score_x_pos = (app->width - text_length) / 2;
 
     static const Color tail_color = { .r = 200, .g = 200, .b = 200, .a = 70 };
     if (!app->x_ray)
     {
-        game_render(&app->game_objects, ball_p1, ball_p2, tail_color);
+        game_render(&app->game.objects, &app->brick_layer, ball, paddle, ball_p1, ball_p2, tail_color);
     }
     else
     {
-        game_render_xray(&app->game_objects, ball_p1, ball_p2, tail_color);
+        game_render_xray(&app->game.objects, ball, paddle, ball_p1, ball_p2, tail_color);
     }
 
     DrawText(score_str, score_x_pos, 10, score_font_size, GRAY); // otherwise ball will be rendered on top of the score
 
-    if (app->game_settings.show_stats)
+    if (app->game.settings.show_stats)
     {
-        const char* ball_speed_str = TextFormat("W: %zu F: %zu %zu", app->wins, app->failes, (size_t)app->game_objects.ball.speed);
+        const char* ball_speed_str = TextFormat("W: %zu F: %zu %zu", app->wins, app->failes, (size_t)app->game.objects.ball.speed);
         const int speed_length = MeasureText(ball_speed_str, score_font_size);
         DrawText(ball_speed_str, app->width - speed_length - 10, 10, score_font_size, GRAY);
     }
@@ -568,13 +448,13 @@ void menu_render_controll(int font_size, const char* text, Color color, bool res
 
 enum State menu_show_controlls(const struct Application* app)
 {
-    if (IsKeyPressed(KEY_A) || IsKeyPressed(KEY_D) || IsKeyPressed(KEY_LEFT) || IsKeyPressed(KEY_RIGHT) || IsKeyPressed(KEY_ESCAPE) || IsKeyPressed(KEY_SPACE) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_LEFT_FACE_RIGHT) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_LEFT_FACE_LEFT) || GetGamepadAxisMovement(0, GAMEPAD_AXIS_LEFT_X) > 0 || GetGamepadAxisMovement(0, GAMEPAD_AXIS_LEFT_X) < 0 || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_RIGHT_FACE_DOWN) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_MIDDLE_RIGHT))
+    if (action_active(&app->actions, ActionStart))
         return Break;
 
     DrawRectangle(app->width / 2.f - 25, 0, 50, 55, (Color) { 10, 10, 10, 255 }); // Draw over the score
     DrawRectangle(0, BRICK_Y_OFFSET, app->width, app->height - BRICK_Y_OFFSET, (Color) { 10, 10, 10, 255 });
 
-    const int font_size = (app->height - 10) / 33;
+    const int font_size = (app->height - 10) / 37;
     menu_render_controll(font_size, "Keyboard", WHITE, false);
     menu_render_controll(font_size, "(A|D|Left|Right) Controll the paddle", WHITE, false);
     menu_render_controll(font_size, "(W|A|Up|Down|1|2) Increase/Decrease the ball's speed", WHITE, false);
@@ -584,16 +464,20 @@ enum State menu_show_controlls(const struct Application* app)
     menu_render_controll(font_size, "(.|,) Increase/Decrease the fps limit", WHITE, false);
     menu_render_controll(font_size, "(R) Reset the game (Doesn't reset the ball speed, wins and fails)", WHITE, false);
     menu_render_controll(font_size, "(L) Reset the game (Including ball speed, wins and fails)", WHITE, false);
+    menu_render_controll(font_size, TextFormat("(N) Spawn %d extra balls (%zu)", EXTRA_BALLS_STRESS, app->game.objects.extra_balls.count), WHITE, false);
 
     menu_render_controll(font_size, TextFormat("(Q) Limit fps (%d)", app->frame_rate), app->limit_fps ? GREEN : RED, false);
     menu_render_controll(font_size, "(X) Render only the outlines of objects", app->x_ray ? GREEN : RED, false);
-    menu_render_controll(font_size, "(O) Auto move the paddle", app->game_settings.auto_move ? GREEN : RED, false);
-    menu_render_controll(font_size, "(U) Auto restart after success or failure", app->game_settings.auto_restart ? GREEN : RED, false);
-    menu_render_controll(font_size, "(G) Bottom has hitbox (Game can no longer be lost)", app->game_settings.make_bottom_hitbox ? GREEN : RED, false);
-    menu_render_controll(font_size, "(P) Paddle has hitbox", app->game_settings.paddle_has_hitbox ? GREEN : RED, false);
-    menu_render_controll(font_size, "(B) Show the game stats (wins, fails, ball speed)", app->game_settings.show_stats ? GREEN : RED, false);
-    menu_render_controll(font_size, "(I) Ball speed increases when scored", app->game_settings.increase_ball_speed ? GREEN : RED, false);
+    menu_render_controll(font_size, "(O) Auto move the paddle", app->game.settings.auto_move ? GREEN : RED, false);
+    menu_render_controll(font_size, "(U) Auto restart after success or failure", app->game.settings.auto_restart ? GREEN : RED, false);
+    menu_render_controll(font_size, "(E) Event driven ball simulation (jumps from collision to collision)", app->game.settings.event_driven ? GREEN : RED, false);
+    menu_render_controll(font_size, TextFormat("(K) Multi ball, every %d. brick spawns %d balls", MULTI_BALL_EVERY, MULTI_BALL_SPAWN), app->game.settings.multi_ball ? GREEN : RED, false);
+    menu_render_controll(font_size, "(G) Bottom has hitbox (Game can no longer be lost)", app->game.settings.make_bottom_hitbox ? GREEN : RED, false);
+    menu_render_controll(font_size, "(P) Paddle has hitbox", app->game.settings.paddle_has_hitbox ? GREEN : RED, false);
+    menu_render_controll(font_size, "(B) Show the game stats (wins, fails, ball speed)", app->game.settings.show_stats ? GREEN : RED, false);
+    menu_render_controll(font_size, "(I) Ball speed increases when scored", app->game.settings.increase_ball_speed ? GREEN : RED, false);
     menu_render_controll(font_size, "(F) Show fps", app->show_fps ? GREEN : RED, false);
+    menu_render_controll(font_size, "(T) Show the frame profiler (min/avg/p99 per phase)", app->show_profiler ? GREEN : RED, false);
     menu_render_controll(font_size, "(M) Mute game audio", !app->sound_objects.failed.play ? GREEN : RED, false);
 
 
@@ -607,11 +491,11 @@ enum State menu_show_controlls(const struct Application* app)
 
     menu_render_controll(font_size, "([]) Render only the outlines of objects", app->x_ray ? GREEN : RED, false);
     menu_render_controll(font_size, "(O) Mute game audio", !app->sound_objects.failed.play ? GREEN : RED, false);
-    menu_render_controll(font_size, "(L1) Show the game stats (wins, fails, ball speed)", app->game_settings.show_stats ? GREEN : RED, false);
-    menu_render_controll(font_size, "(R1) Ball speed increases when scored", app->game_settings.increase_ball_speed ? GREEN : RED, false);
+    menu_render_controll(font_size, "(L1) Show the game stats (wins, fails, ball speed)", app->game.settings.show_stats ? GREEN : RED, false);
+    menu_render_controll(font_size, "(R1) Ball speed increases when scored", app->game.settings.increase_ball_speed ? GREEN : RED, false);
     menu_render_controll(font_size, "(SHARE) Show fps", app->show_fps ? GREEN : RED, false);
-    menu_render_controll(font_size, "(Left Stick pressed) Paddle has hitbox", app->game_settings.paddle_has_hitbox ? GREEN : RED, false);
-    menu_render_controll(font_size, "(Right Stick pressed) Bottom has hitbox (Game can no longer be lost)", app->game_settings.make_bottom_hitbox ? GREEN : RED, true);
+    menu_render_controll(font_size, "(Left Stick pressed) Paddle has hitbox", app->game.settings.paddle_has_hitbox ? GREEN : RED, false);
+    menu_render_controll(font_size, "(Right Stick pressed) Bottom has hitbox (Game can no longer be lost)", app->game.settings.make_bottom_hitbox ? GREEN : RED, true);
     return app->state;
 }
 
@@ -629,12 +513,12 @@ enum State on_menu_update(const struct Application* app, const char* text)
     case Menu:
     case Break:
         DrawText(text, x_pos, y_pos, app->font_size_menu, DARKGRAY);
-        if (IsKeyPressed(KEY_A) || IsKeyPressed(KEY_D) || IsKeyPressed(KEY_LEFT) || IsKeyPressed(KEY_RIGHT) || IsKeyPressed(KEY_ESCAPE) || IsKeyPressed(KEY_SPACE) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_LEFT_FACE_RIGHT) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_LEFT_FACE_LEFT) || GetGamepadAxisMovement(0, GAMEPAD_AXIS_LEFT_X) > 0 || GetGamepadAxisMovement(0, GAMEPAD_AXIS_LEFT_X) < 0 || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_RIGHT_FACE_DOWN) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_MIDDLE_RIGHT))
+        if (action_active(&app->actions, ActionStart))
         {
             play_sound(app->sound_objects.start);
             return Game;
         }
-        return IsKeyPressed(KEY_R) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_RIGHT_FACE_UP) ? Reset : (IsKeyPressed(KEY_L) ? ResetAll : app->state);
+        return action_active(&app->actions, ActionReset) ? Reset : (action_active(&app->actions, ActionResetAll) ? ResetAll : app->state);
     case Success:
         DrawText(text, x_pos, y_pos, app->font_size_menu, GOLD);
         break;
@@ -645,10 +529,10 @@ enum State on_menu_update(const struct Application* app, const char* text)
         break;
     }
 
-    if (IsKeyPressed(KEY_L))
+    if (action_active(&app->actions, ActionResetAll))
         return ResetAll;
 
-    if (app->game_settings.auto_restart || IsKeyPressed(KEY_R) || IsKeyPressed(KEY_ESCAPE) || IsKeyPressed(KEY_SPACE) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_RIGHT_FACE_DOWN) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_RIGHT_FACE_UP))
+    if (app->game.settings.auto_restart || action_active(&app->actions, ActionDismiss))
         return Reset;
     return app->state;
 }
@@ -662,46 +546,39 @@ float app_transform(float old_value, float old_dimension, float new_dimension)
 
 void on_app_resize(struct Application* app, int new_width, int new_height)
 {
-    const float brick_width = new_width / (float)BRICKS_HOR - BRICK_PADDING * 2;
-    const float brick_height = app_transform(app->game_objects.bricks[0].rec.height, app->height, new_height);
-
-    app->game_objects.paddle.height = brick_height;
-    app->game_objects.paddle.width = app_transform(app->game_objects.paddle.width, app->width, new_width);
-    app->game_objects.paddle.x = app_transform(app->game_objects.paddle.x, app->width, new_width);
-    app->game_objects.paddle.y = app_transform(app->game_objects.paddle.y, app->height, new_height);
-
-    app->game_objects.ball.center.x = app_transform(app->game_objects.ball.center.x, app->width, new_width);
-    app->game_objects.ball.center.y = app_transform(app->game_objects.ball.center.y, app->height, new_height);
-    app->game_objects.ball.radius = app_transform(app->game_objects.ball.radius, app->width, new_width);
-    app->game_objects.ball.tail.p1.x = app_transform(app->game_objects.ball.tail.p1.x, app->width, new_width);
-    app->game_objects.ball.tail.p1.y = app_transform(app->game_objects.ball.tail.p1.y, app->height, new_height);
-    app->game_objects.ball.tail.p2.x = app_transform(app->game_objects.ball.tail.p2.x, app->width, new_width);
-    app->game_objects.ball.tail.p2.y = app_transform(app->game_objects.ball.tail.p2.y, app->height, new_height);
-    app->game_objects.ball.tail.p3.x = app_transform(app->game_objects.ball.tail.p3.x, app->width, new_width);
-    app->game_objects.ball.tail.p3.y = app_transform(app->game_objects.ball.tail.p3.y, app->height, new_height);
-
-    float current_x = BRICK_PADDING;
-    float current_y = 60;
-    for (size_t i = 0; i < NUM_BRICKS; ++i)
-    {
-        if (app->game_objects.bricks[i].rec.width == 0)
-            continue;
-        app->game_objects.bricks[i].rec.x = current_x;
-        app->game_objects.bricks[i].rec.y = current_y;
-        app->game_objects.bricks[i].rec.width = brick_width;
-        app->game_objects.bricks[i].rec.height = brick_height;
-        current_x += brick_width + BRICK_PADDING * 2;
-
-        if ((i + 1) % BRICKS_HOR == 0)
-        {
-            current_x = BRICK_PADDING;
-            current_y += brick_height + 5;
-        }
+    const float brick_height = app->game.objects.bricks.count == 0 ? 0 : app_transform(app->game.objects.bricks.height[0], app->height, new_height);
+
+    app->game.objects.paddle.height = app_transform(app->game.objects.paddle.height, app->height, new_height);
+    app->game.objects.paddle.width = app_transform(app->game.objects.paddle.width, app->width, new_width);
+    app->game.objects.paddle.x = app_transform(app->game.objects.paddle.x, app->width, new_width);
+    app->game.objects.paddle.y = app_transform(app->game.objects.paddle.y, app->height, new_height);
+
+    app->game.objects.ball.center.x = app_transform(app->game.objects.ball.center.x, app->width, new_width);
+    app->game.objects.ball.center.y = app_transform(app->game.objects.ball.center.y, app->height, new_height);
+    app->game.objects.ball.radius = app_transform(app->game.objects.ball.radius, app->width, new_width);
+    app->game.objects.ball.tail.p1.x = app_transform(app->game.objects.ball.tail.p1.x, app->width, new_width);
+    app->game.objects.ball.tail.p1.y = app_transform(app->game.objects.ball.tail.p1.y, app->height, new_height);
+    app->game.objects.ball.tail.p2.x = app_transform(app->game.objects.ball.tail.p2.x, app->width, new_width);
+    app->game.objects.ball.tail.p2.y = app_transform(app->game.objects.ball.tail.p2.y, app->height, new_height);
+    app->game.objects.ball.tail.p3.x = app_transform(app->game.objects.ball.tail.p3.x, app->width, new_width);
+    app->game.objects.ball.tail.p3.y = app_transform(app->game.objects.ball.tail.p3.y, app->height, new_height);
+
+    bricks_layout(&app->game.objects, new_width, brick_height);
+
+    struct ExtraBalls* balls = &app->game.objects.extra_balls;
+    for (size_t i = 0; i < balls->count; ++i)
+    {
+        balls->x[i] = app_transform(balls->x[i], app->width, new_width);
+        balls->y[i] = app_transform(balls->y[i], app->height, new_height);
     }
 
     app->font_size_menu = app_transform(app->font_size_menu, MAX(app->width, app->height), MAX(new_width, new_height));
     app->width = new_width;
     app->height = new_height;
+    app->game.width = new_width;
+    app->game.height = new_height;
+    fixed_timestep_snap(&app->timestep, &app->game.objects);
+    brick_layer_resize(&app->brick_layer, new_width, new_height);
 }
 
 
@@ -742,7 +619,40 @@ Texture2D load_image(const unsigned char* data, int size)
 }
 
 
-struct Application app_start()
+// --bricks <hor>x<ver> sets the size of the brick field, e.g. --bricks 200x150
+// --threads <n> sets the number of threads that move the extra balls (or play the games of --simulate)
+// --record <file> saves the input of every step when the game is closed, --replay <file> plays it back headless
+// everything batch_parse_arg() takes runs games without a window instead, see batch.h
+void app_parse_args(struct Application* app, int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        int hor, ver;
+        if (strcmp(argv[i], "--bricks") == 0 && i + 1 < argc && sscanf(argv[i + 1], "%dx%d", &hor, &ver) == 2)
+        {
+            app->bricks_hor = MAX(1, MIN(hor, BRICKS_MAX));
+            app->bricks_ver = MAX(1, MIN(ver, BRICKS_MAX));
+            ++i;
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc && sscanf(argv[i + 1], "%d", &hor) == 1)
+        {
+            app->threads = MAX(1, MIN(hor, THREAD_POOL_MAX));
+            ++i;
+        }
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+        {
+            app->record_path = argv[i + 1];
+            ++i;
+        }
+        else if (!batch_parse_arg(&app->batch, argc, argv, &i))
+        {
+            TraceLog(LOG_WARNING, "Ignoring unknown argument '%s'", argv[i]);
+        }
+    }
+}
+
+
+struct Application app_start(int argc, char** argv)
 {
     struct Application app;
     app.wins = 0;
@@ -750,17 +660,52 @@ struct Application app_start()
     app.width = 1200;
     app.height = 750;
     app.state = Menu;
+    app.last_state = Menu;
     app.x_ray = false;
     app.show_fps = false;
+    app.show_profiler = false;
+    profiler_init(&app.profiler);
+    actions_init(&app.actions);
+    app.latency_pending = 0;
     app.limit_fps = false;
     app.frame_rate = 60;
     app.font_size_menu = 90;
-    app.game_objects = game_objects_init(app.width, app.height, 230, 30, 500.f);
-    app.game_settings = (struct GameSettings){ .make_bottom_hitbox = false, .paddle_has_hitbox = true, .show_stats = false, .increase_ball_speed = true, .auto_restart = false, .auto_move = false };
+    app.bricks_hor = BRICKS_HOR;
+    app.bricks_ver = BRICKS_VER;
+    app.threads = thread_pool_hardware_threads();
+    app.batch = batch_default_options();
+    app.record_path = NULL;
+    app_parse_args(&app, argc, argv);
+    if (!arena_init(&app.level_arena, game_objects_level_size(app.bricks_hor, app.bricks_ver, EXTRA_BALLS_MAX)))
+    {
+        TraceLog(LOG_ERROR, "Failed to allocate memory for %dx%d bricks", app.bricks_hor, app.bricks_ver);
+        exit(EXIT_FAILURE); // nothing else is started yet
+    }
+    app.game.width = app.width;
+    app.game.height = app.height;
+    app.game.pool = thread_pool_create(app.threads);
+    app.game.objects = game_objects_init(&app.level_arena, app.width, app.height, app.bricks_hor, app.bricks_ver, EXTRA_BALLS_MAX, 230, 30, 500.f);
+    app.game.settings = (struct GameSettings){ .make_bottom_hitbox = false, .paddle_has_hitbox = true, .show_stats = false, .increase_ball_speed = true, .auto_restart = false, .auto_move = false, .event_driven = false, .multi_ball = false };
+    app.timestep = fixed_timestep_init(SIM_DEFAULT_RATE, SIM_MAX_CATCH_UP_STEPS);
+    fixed_timestep_snap(&app.timestep, &app.game.objects);
+    if (batch_headless(&app.batch))
+        return app; // headless, no window and no audio
+
+    if (app.record_path != NULL)
+    {
+        const struct ReplayHeader header = { SIM_DEFAULT_RATE, (float)app.width, (float)app.height, app.bricks_hor, app.bricks_ver, 230, 30, 500.f, 0, game_settings_pack(&app.game.settings) };
+        replay_record_begin(&app.replay, &header);
+    }
+
+#ifdef RL_TRACE_ZONES
+    if (rlTraceOpen(TRACE_FILE))
+        TraceLog(LOG_INFO, "Writing trace zones to '%s', (F9) flushes them", TRACE_FILE);
+#endif
 
     InitAudioDevice();
     InitWindow(app.width, app.height, "Breakout");
-    SetWindowState(FLAG_WINDOW_RESIZABLE);
+    if (app.record_path == NULL)
+        SetWindowState(FLAG_WINDOW_RESIZABLE); // a resize moves the objects outside of the simulation, a replay couldn't follow
     SetExitKey(KEY_NULL);
     Image icon = LoadImageFromMemory(".png", sg_Icon_image, ARRAY_SIZE(sg_Icon_image));
     SetWindowIcon(icon);
@@ -769,14 +714,26 @@ struct Application app_start()
     app_load_audio(&app);
     app.volume_on = load_image(sg_Volume_on_image, ARRAY_SIZE(sg_Volume_on_image));
     app.volume_off = load_image(sg_Volume_off_image, ARRAY_SIZE(sg_Volume_off_image));
+    brick_layer_init(&app.brick_layer, app.width, app.height);
     return app;
 }
 
 
-void app_shutdown(const struct Application* app)
+void app_shutdown(struct Application* app)
 {
+    if (app->record_path != NULL)
+    {
+        if (replay_save(&app->replay, app->record_path))
+            TraceLog(LOG_INFO, "Saved the replay to '%s'", app->record_path);
+        else
+            TraceLog(LOG_WARNING, "Failed to save the replay to '%s'", app->record_path);
+        replay_free(&app->replay);
+    }
+    thread_pool_destroy(app->game.pool);
+    arena_free(&app->level_arena);
     UnloadTexture(app->volume_on);
     UnloadTexture(app->volume_off);
+    brick_layer_free(&app->brick_layer);
     UnloadSound(app->sound_objects.success.sound);
     UnloadSound(app->sound_objects.failed.sound);
     UnloadSound(app->sound_objects.start.sound);
@@ -784,17 +741,20 @@ void app_shutdown(const struct Application* app)
     UnloadSound(app->sound_objects.hit_paddle.sound);
     CloseAudioDevice();
     TerminateWindow();
+#ifdef RL_TRACE_ZONES
+    rlTraceClose(); // after the audio thread is gone
+#endif
 }
 
 
 void on_app_key_input(struct Application* app)
 {
-    if (IsKeyPressed(KEY_X) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_RIGHT_FACE_LEFT))
+    if (action_active(&app->actions, ActionXRay))
     {
         app->x_ray = !app->x_ray;
     }
 
-    if (IsKeyPressed(KEY_M) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_RIGHT_FACE_RIGHT))
+    if (action_active(&app->actions, ActionMute))
     {
         app->sound_objects.hit_brick.play = !app->sound_objects.hit_brick.play;
         app->sound_objects.hit_paddle.play = !app->sound_objects.hit_paddle.play;
@@ -803,108 +763,140 @@ void on_app_key_input(struct Application* app)
         app->sound_objects.success.play = !app->sound_objects.success.play;
     }
 
-    if (IsKeyPressed(KEY_F3) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_RIGHT_TRIGGER_2))
+    if (action_active(&app->actions, ActionControlls))
     {
         app->state = Controlls;
     }
 
-    if (IsKeyPressed(KEY_F) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_MIDDLE_LEFT))
+    if (action_active(&app->actions, ActionShowFps))
     {
         app->show_fps = !app->show_fps;
     }
 
-    if (IsKeyPressed(KEY_G) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_RIGHT_THUMB))
+    if (action_active(&app->actions, ActionShowProfiler))
     {
-        app->game_settings.make_bottom_hitbox = !app->game_settings.make_bottom_hitbox;
+        app->show_profiler = !app->show_profiler;
     }
 
-    if (IsKeyPressed(KEY_P) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_LEFT_THUMB))
+#ifdef RL_TRACE_ZONES
+    if (action_active(&app->actions, ActionFlushTrace))
+    {
+        rlTraceFlush(); // the file can be opened while the game keeps running
+    }
+#endif
+
+    if (action_active(&app->actions, ActionBottomHitbox))
     {
-        app->game_settings.paddle_has_hitbox = !app->game_settings.paddle_has_hitbox;
+        app->game.settings.make_bottom_hitbox = !app->game.settings.make_bottom_hitbox;
     }
 
-    if (IsKeyPressed(KEY_B) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_LEFT_TRIGGER_1))
+    if (action_active(&app->actions, ActionPaddleHitbox))
     {
-        app->game_settings.show_stats = !app->game_settings.show_stats;
+        app->game.settings.paddle_has_hitbox = !app->game.settings.paddle_has_hitbox;
     }
 
-    if (IsKeyPressed(KEY_I) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_RIGHT_TRIGGER_1))
+    if (action_active(&app->actions, ActionShowStats))
     {
-        app->game_settings.increase_ball_speed = !app->game_settings.increase_ball_speed;
+        app->game.settings.show_stats = !app->game.settings.show_stats;
     }
 
-    if (IsKeyPressed(KEY_O))
+    if (action_active(&app->actions, ActionIncreaseBallSpeed))
     {
-        app->game_settings.auto_move = !app->game_settings.auto_move;
+        app->game.settings.increase_ball_speed = !app->game.settings.increase_ball_speed;
     }
 
-    if (IsKeyPressed(KEY_U))
+    if (action_active(&app->actions, ActionAutoMove))
     {
-        app->game_settings.auto_restart = !app->game_settings.auto_restart;
+        app->game.settings.auto_move = !app->game.settings.auto_move;
     }
 
-    if (IsKeyPressed(KEY_Q))
+    if (action_active(&app->actions, ActionAutoRestart))
+    {
+        app->game.settings.auto_restart = !app->game.settings.auto_restart;
+    }
+
+    if (action_active(&app->actions, ActionEventDriven))
+    {
+        app->game.settings.event_driven = !app->game.settings.event_driven;
+    }
+
+    if (action_active(&app->actions, ActionMultiBall))
+    {
+        app->game.settings.multi_ball = !app->game.settings.multi_ball;
+    }
+
+    if (action_active(&app->actions, ActionLimitFps))
     {
         app->limit_fps = !app->limit_fps;
         SetTargetFPS(app->limit_fps ? app->frame_rate : 0);
     }
 
-    if (KEY_REPEAT(KEY_PERIOD))
+    if (action_active(&app->actions, ActionFpsUp))
     {
         app->frame_rate += 1;
         SetTargetFPS(app->frame_rate);
     }
 
-    if (KEY_REPEAT(KEY_COMMA))
+    if (action_active(&app->actions, ActionFpsDown))
     {
         app->frame_rate -= 1;
         app->frame_rate = MAX(app->frame_rate, 1);
         SetTargetFPS(app->frame_rate);
     }
 
-    if (IsKeyDown(KEY_TWO))
+    if (action_active(&app->actions, ActionSpeedUpFast))
     {
-        app->game_objects.ball.speed += 100.f;
-        app->game_objects.ball.speed = MIN(app->game_objects.ball.speed, 1000000000);
+        app->game.objects.ball.speed += 100.f;
+        app->game.objects.ball.speed = MIN(app->game.objects.ball.speed, 1000000000);
     }
 
-    if (IsKeyDown(KEY_ONE))
+    if (action_active(&app->actions, ActionSpeedDownFast))
     {
-        app->game_objects.ball.speed -= 100.f;
-        app->game_objects.ball.speed = MAX(app->game_objects.ball.speed, 1);
+        app->game.objects.ball.speed -= 100.f;
+        app->game.objects.ball.speed = MAX(app->game.objects.ball.speed, 1);
     }
 
-    if (KEY_REPEAT(KEY_W))
+    if (action_active(&app->actions, ActionSpeedUp))
     {
-        app->game_objects.ball.speed += 100.f;
-        app->game_objects.ball.speed = MIN(app->game_objects.ball.speed, 1000000000);
+        app->game.objects.ball.speed += 100.f;
+        app->game.objects.ball.speed = MIN(app->game.objects.ball.speed, 1000000000);
     }
 
-    if (KEY_REPEAT(KEY_S))
+    if (action_active(&app->actions, ActionSpeedDown))
     {
-        app->game_objects.ball.speed -= 100.f;
-        app->game_objects.ball.speed = MAX(app->game_objects.ball.speed, 1);
+        app->game.objects.ball.speed -= 100.f;
+        app->game.objects.ball.speed = MAX(app->game.objects.ball.speed, 1);
     }
 
-    if (KEY_REPEAT(KEY_UP) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_LEFT_FACE_UP))
+    if (action_active(&app->actions, ActionSpeedUpFine))
     {
-        app->game_objects.ball.speed += 10.f;
-        app->game_objects.ball.speed = MIN(app->game_objects.ball.speed, 10000000);
+        app->game.objects.ball.speed += 10.f;
+        app->game.objects.ball.speed = MIN(app->game.objects.ball.speed, 10000000);
     }
 
-    if (KEY_REPEAT(KEY_DOWN) || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_LEFT_FACE_DOWN))
+    if (action_active(&app->actions, ActionSpeedDownFine))
     {
-        app->game_objects.ball.speed -= 10.f;
-        app->game_objects.ball.speed = MAX(app->game_objects.ball.speed, 1);
+        app->game.objects.ball.speed -= 10.f;
+        app->game.objects.ball.speed = MAX(app->game.objects.ball.speed, 1);
     }
 }
 
 
+// Nothing moves in these states, the frame only changes with input or a resize
+bool state_is_static(enum State state)
+{
+    return state == Menu || state == Break || state == Success || state == Failed || state == Controlls;
+}
+
+
 void GameLoop(void* a)
 {
     struct Application* app = (struct Application*)a;
+    const enum State state = app->state;
 
-    on_app_key_input(app);
+    profiler_next_frame(&app->profiler);
+    PROFILE(&app->profiler, PhaseKeyInput, actions_sample(&app->actions));
+    PROFILE(&app->profiler, PhaseKeyInput, on_app_key_input(app));
 
     if (IsWindowResized())
     {
@@ -917,56 +909,85 @@ void GameLoop(void* a)
     if (app->show_fps)
     {
         DrawFPS(10, 10);
+        // counted by rlgl up to the last EndDrawing, this frame isn't done yet
+        const rlFrameStats stats = rlGetFrameStats();
+        DrawText(TextFormat("%u draws, %u vertices, %u flushes (%u full), %u textures, %u states", stats.drawCalls, stats.vertices, stats.batchFlushes, stats.exhaustedFlushes, stats.textureSwitches, stats.stateChanges), 10, 35, 20, LIME);
     }
 
 
     switch (app->state)
     {
     case Menu:
-        on_game_render(app);
+        PROFILE(&app->profiler, PhaseGameRender, on_game_render(app));
         app->state = on_menu_update(app, "Press A|D to start"); // to render the menu on top of the game not vice versa
         break;
     case Game:
-        app->state = on_game_update(app, GetFrameTime());
-        on_game_render(app);
+        // the last frame's time belongs to the menu if the game was just started or resumed, waiting for input included
+        PROFILE(&app->profiler, PhaseGameUpdate, app->state = on_game_update(app, app->last_state == Game ? GetFrameTime() : 0.f));
+        PROFILE(&app->profiler, PhaseGameRender, on_game_render(app));
         break;
     case Break:
-        on_game_render(app);
+        PROFILE(&app->profiler, PhaseGameRender, on_game_render(app));
         app->state = on_menu_update(app, "Paused");
         break;
     case Success:
-        on_game_render(app);
+        PROFILE(&app->profiler, PhaseGameRender, on_game_render(app));
         app->state = on_menu_update(app, "You won!");
         break;
     case Failed:
-        on_game_render(app);
+        PROFILE(&app->profiler, PhaseGameRender, on_game_render(app));
         app->state = on_menu_update(app, "You lost!");
         break;
     case Reset:
-        app->game_objects = game_objects_init(app->width, app->height, 230, 30, app->game_objects.ball.speed);
-        app->state = app->game_settings.auto_restart ? Game : Menu;
+        app->game.objects = game_objects_init(&app->level_arena, app->width, app->height, app->bricks_hor, app->bricks_ver, EXTRA_BALLS_MAX, 230, 30, app->game.objects.ball.speed);
+        if (app->record_path != NULL)
+            replay_record_reset(&app->replay, app->game.objects.ball.speed);
+        fixed_timestep_snap(&app->timestep, &app->game.objects);
+        app->state = app->game.settings.auto_restart ? Game : Menu;
         break;
     case ResetAll:
         app->wins = 0;
         app->failes = 0;
-        app->game_objects = game_objects_init(app->width, app->height, 230, 30, 500.f);
-        app->state = app->game_settings.auto_restart ? Game : Menu;
+        app->game.objects = game_objects_init(&app->level_arena, app->width, app->height, app->bricks_hor, app->bricks_ver, EXTRA_BALLS_MAX, 230, 30, 500.f);
+        if (app->record_path != NULL)
+            replay_record_reset(&app->replay, 500.f);
+        fixed_timestep_snap(&app->timestep, &app->game.objects);
+        app->state = app->game.settings.auto_restart ? Game : Menu;
         break;
     case Controlls:
-        on_game_render(app); // render the game to see stats like the ball speed etc.
+        PROFILE(&app->profiler, PhaseGameRender, on_game_render(app)); // render the game to see stats like the ball speed etc.
         app->state = menu_show_controlls(app);
         break;
     default:
         break;
     }
 
+    if (app->show_profiler)
+    {
+        profiler_draw(&app->profiler, 10, app->show_fps ? 65 : 40);
+    }
+
+    // once a static frame has been drawn, the next one waits for input, the fps counter and the profiler keep it running
+    if (state_is_static(state) && state_is_static(app->state) && !app->show_fps && !app->show_profiler)
+        EnableEventWaiting();
+    else
+        DisableEventWaiting();
+    app->last_state = state;
+
     EndDrawing();
 }
 
 
-int main()
+int main(int argc, char** argv)
 {
-    struct Application app = app_start();
+    struct Application app = app_start(argc, argv);
+    if (batch_headless(&app.batch))
+    {
+        const int result = app.batch.replay_path != NULL ? batch_replay(app.batch.replay_path, app.game.pool) : batch_run(&app.batch, app.game.pool, app.bricks_hor, app.bricks_ver);
+        thread_pool_destroy(app.game.pool);
+        arena_free(&app.level_arena);
+        return result;
+    }
 
 #ifdef SYSTEM_WEB
     emscripten_set_main_loop_arg(GameLoop, &app, 0, 1);
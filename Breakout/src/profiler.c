@@ -0,0 +1,182 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "profiler.h"
+#include "rlgl.h" // after raylib.h, it shares its types
+
+#define PROFILER_FONT_SIZE    20
+#define PROFILER_WIDTH        (PROFILER_FRAMES * 2)
+#define PROFILER_GRAPH_HEIGHT 100
+#define PROFILER_GRAPH_MS     50.f // at the top of the graph
+
+
+static const char* sg_PhaseNames[PhaseCount] = {
+    "key input",
+    "game update",
+    "game render",
+    "draw batch",
+    "swap buffers",
+    "wait",
+    "poll events"
+};
+
+
+void profiler_init(struct Profiler* profiler)
+{
+    memset(profiler, 0, sizeof(struct Profiler));
+}
+
+
+void profiler_next_frame(struct Profiler* profiler)
+{
+    const FramePhaseTimes phases = GetFramePhaseTimes();
+    float* times = profiler->times[profiler->current];
+    times[PhaseDrawBatch] = (float)phases.drawBatch;
+    times[PhaseSwapBuffers] = (float)phases.swapBuffers;
+    times[PhaseWait] = (float)phases.wait;
+    times[PhasePollEvents] = (float)phases.pollEvents;
+    profiler->frame_times[profiler->current] = GetFrameTime();
+
+    // the slot of the current frame isn't complete yet and never counts
+    if (profiler->count < PROFILER_FRAMES - 1)
+        profiler->count++;
+    profiler->current = (profiler->current + 1) % PROFILER_FRAMES;
+    memset(profiler->times[profiler->current], 0, sizeof(profiler->times[profiler->current]));
+    profiler->stats_age++;
+}
+
+
+void profiler_add(struct Profiler* profiler, enum ProfilerPhase phase, double seconds)
+{
+    profiler->times[profiler->current][phase] += (float)seconds;
+}
+
+
+void profiler_add_latency(struct Profiler* profiler, double seconds)
+{
+    profiler->latencies[profiler->latency_next] = (float)seconds;
+    profiler->latency_next = (profiler->latency_next + 1) % PROFILER_LATENCIES;
+    if (profiler->latency_count < PROFILER_LATENCIES)
+        profiler->latency_count++;
+}
+
+
+int profiler_compare(const void* a, const void* b)
+{
+    const float x = *(const float*)a;
+    const float y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+
+
+// values is sorted in place
+struct ProfilerStats profiler_stats(float* values, size_t count)
+{
+    struct ProfilerStats stats = { 0 };
+    if (count == 0)
+        return stats;
+
+    qsort(values, count, sizeof(float), profiler_compare);
+    float sum = 0;
+    for (size_t i = 0; i < count; ++i)
+        sum += values[i];
+
+    stats.min = values[0];
+    stats.avg = sum / count;
+    stats.p99 = values[(count * 99 + 99) / 100 - 1];
+    return stats;
+}
+
+
+void profiler_update_stats(struct Profiler* profiler)
+{
+    float values[PROFILER_FRAMES];
+    for (int phase = 0; phase <= PhaseCount; ++phase)
+    {
+        for (size_t i = 0; i < profiler->count; ++i)
+        {
+            const size_t frame = (profiler->current + PROFILER_FRAMES - 1 - i) % PROFILER_FRAMES;
+            values[i] = phase == PhaseCount ? profiler->frame_times[frame] : profiler->times[frame][phase];
+        }
+
+        const struct ProfilerStats stats = profiler_stats(values, profiler->count);
+        if (phase == PhaseCount)
+            profiler->frame_stats = stats;
+        else
+            profiler->stats[phase] = stats;
+    }
+
+    memcpy(values, profiler->latencies, sizeof(profiler->latencies));
+    profiler->latency_stats = profiler_stats(values, profiler->latency_count);
+    profiler->stats_age = 0;
+}
+
+
+void profiler_draw_row(int x, int y, const char* name, struct ProfilerStats stats, Color color)
+{
+    DrawText(name, x, y, PROFILER_FONT_SIZE, color);
+    DrawText(TextFormat("%7.3f %7.3f %7.3f", stats.min * 1000.f, stats.avg * 1000.f, stats.p99 * 1000.f), x + 150, y, PROFILER_FONT_SIZE, color);
+}
+
+
+void profiler_draw(struct Profiler* profiler, int x, int y)
+{
+    if (profiler->stats_age >= PROFILER_STATS_EVERY)
+        profiler_update_stats(profiler);
+
+    // app, raylib and waiting, the same colors stack up in the graph
+    static const Color group_colors[] = { SKYBLUE, ORANGE, DARKGRAY };
+    const FramePacingStats pacing = GetFramePacingStats();
+    const bool deadline_pacing = pacing.spinMargin > 0; // raylib measures it only with deadline pacing (Linux)
+    const rlBatchExhaustion exhaustion = rlGetBatchExhaustion();
+    const int rows = PhaseCount + 4 + deadline_pacing;
+    DrawRectangle(x - 5, y - 5, PROFILER_WIDTH + 10, rows * PROFILER_FONT_SIZE + PROFILER_GRAPH_HEIGHT + 15, (Color){ 0, 0, 0, 200 });
+
+    DrawText("phase (ms)", x, y, PROFILER_FONT_SIZE, WHITE);
+    DrawText("    min     avg     p99", x + 150, y, PROFILER_FONT_SIZE, WHITE);
+    for (int phase = 0; phase < PhaseCount; ++phase)
+    {
+        const Color color = group_colors[phase <= PhaseGameRender ? 0 : (phase == PhaseWait ? 2 : 1)];
+        profiler_draw_row(x, y + (phase + 1) * PROFILER_FONT_SIZE, sg_PhaseNames[phase], profiler->stats[phase], color);
+    }
+    profiler_draw_row(x, y + (PhaseCount + 1) * PROFILER_FONT_SIZE, "frame", profiler->frame_stats, WHITE);
+    profiler_draw_row(x, y + (PhaseCount + 2) * PROFILER_FONT_SIZE, "input to step", profiler->latency_stats, LIGHTGRAY);
+    if (deadline_pacing)
+    {
+        // jitter avg/max, spin avg/margin
+        DrawText(TextFormat("jitter %.0f/%.0f spin %.0f/%.0f us, %u missed", pacing.jitterAvg * 1e6, pacing.jitterMax * 1e6, pacing.spinAvg * 1e6,
+            pacing.spinMargin * 1e6, pacing.missed), x, y + (PhaseCount + 3) * PROFILER_FONT_SIZE, PROFILER_FONT_SIZE, LIGHTGRAY);
+    }
+    // every one is an extra draw and upload in the middle of a frame
+    DrawText(TextFormat("batch full: %u vertex, %u draw call flushes", exhaustion.vertexFlushes, exhaustion.drawCallFlushes),
+        x, y + (rows - 1) * PROFILER_FONT_SIZE, PROFILER_FONT_SIZE, LIGHTGRAY);
+
+    // frame times, oldest on the left, each stacked by group
+    const int bottom = y + rows * PROFILER_FONT_SIZE + 5 + PROFILER_GRAPH_HEIGHT;
+    const float scale = PROFILER_GRAPH_HEIGHT / (PROFILER_GRAPH_MS / 1000.f);
+    for (size_t i = 0; i < profiler->count; ++i)
+    {
+        const size_t frame = (profiler->current + PROFILER_FRAMES - profiler->count + i) % PROFILER_FRAMES;
+        const float* times = profiler->times[frame];
+        const float groups[] = {
+            times[PhaseKeyInput] + times[PhaseGameUpdate] + times[PhaseGameRender],
+            times[PhaseDrawBatch] + times[PhaseSwapBuffers] + times[PhasePollEvents],
+            times[PhaseWait]
+        };
+
+        float height = 0;
+        for (int g = 0; g < 3; ++g)
+        {
+            const float top = height + groups[g] * scale;
+            const int from = (int)height;
+            const int to = (int)(top < PROFILER_GRAPH_HEIGHT ? top : PROFILER_GRAPH_HEIGHT);
+            if (to > from)
+                DrawRectangle(x + (int)i * 2, bottom - to, 2, to - from, group_colors[g]);
+            height = top;
+        }
+    }
+
+    // 60 fps budget
+    const int budget = bottom - (int)(scale / 60.f);
+    DrawLine(x, budget, x + PROFILER_WIDTH, budget, RED);
+}
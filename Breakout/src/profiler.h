@@ -0,0 +1,60 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stddef.h>
+
+#include "raylib.h"
+
+#define PROFILER_FRAMES      240 // ring buffer size, 4 seconds at 60 fps
+#define PROFILER_STATS_EVERY 30  // frames between refreshing min/avg/p99, sorting every frame would cost more than it measures
+#define PROFILER_LATENCIES   64  // ring buffer size of the input latencies
+
+/*
+    Where the time of a frame goes, the game's phases are measured in GameLoop(),
+    the ones of EndDrawing() come from raylib's GetFramePhaseTimes().
+    Everything lives in fixed size arrays, measuring never allocates.
+*/
+enum ProfilerPhase
+{
+    PhaseKeyInput,
+    PhaseGameUpdate,
+    PhaseGameRender,
+    PhaseDrawBatch,
+    PhaseSwapBuffers,
+    PhaseWait,
+    PhasePollEvents,
+    PhaseCount
+};
+
+
+struct ProfilerStats
+{
+    float min;
+    float avg;
+    float p99;
+};
+
+
+struct Profiler
+{
+    float times[PROFILER_FRAMES][PhaseCount]; // seconds
+    float frame_times[PROFILER_FRAMES];
+    size_t current; // the frame being measured
+    size_t count;   // frames in the ring buffer, at most PROFILER_FRAMES
+    size_t stats_age;
+    struct ProfilerStats stats[PhaseCount];
+    struct ProfilerStats frame_stats;
+    float latencies[PROFILER_LATENCIES]; // seconds from an input to the simulation step that applied it
+    size_t latency_count;
+    size_t latency_next;
+    struct ProfilerStats latency_stats;
+};
+
+
+void profiler_init(struct Profiler* profiler);
+void profiler_next_frame(struct Profiler* profiler); // at the start of a frame, completes the last one with its EndDrawing() phases
+void profiler_add(struct Profiler* profiler, enum ProfilerPhase phase, double seconds);
+void profiler_add_latency(struct Profiler* profiler, double seconds); // from an input to the simulation step that applied it
+void profiler_draw(struct Profiler* profiler, int x, int y);
+
+#endif // PROFILER_H
@@ -9,22 +9,27 @@
     However in order to link against WinMain() I created this macro.
     GCC & MSVC properly link against WinMain().
     Premake will define all these macros for you if you select clang as compiler.
+
+    main() takes the command line, so the macro turns it into app_main() and defines a
+    WinMain() that forwards the CRT's __argc and __argv to it.
 */
 
 #if defined TOOLCHAIN_CLANG && defined RELEASE && defined SYSTEM_WINDOWS
+    #include <stdlib.h> // __argc, __argv
+
     #ifdef __cplusplus
         #ifdef _WINBASE_
-            #define main() WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
+            #define main(...) app_main(__VA_ARGS__); int WinMain(HINSTANCE, HINSTANCE, LPSTR, int) { return app_main(__argc, __argv); } int app_main(__VA_ARGS__)
         #else
-            #define main() __stdcall WinMain(void*, void*, char*, int)
+            #define main(...) app_main(__VA_ARGS__); int __stdcall WinMain(void*, void*, char*, int) { return app_main(__argc, __argv); } int app_main(__VA_ARGS__)
         #endif // _WINBASE_
     #else
         #ifdef _WINBASE_
-            #define main() WinMain(HINSTANCE hInst, HINSTANCE hInstPrev, LPSTR cmdline, int cmdshow)
+            #define main(...) app_main(__VA_ARGS__); int WinMain(HINSTANCE hInst, HINSTANCE hInstPrev, LPSTR cmdline, int cmdshow) { return app_main(__argc, __argv); } int app_main(__VA_ARGS__)
         #else
-            #define main() __stdcall WinMain(void* hInst, void* hInstPrev, char* cmdline, int cmdshow)
+            #define main(...) app_main(__VA_ARGS__); int __stdcall WinMain(void* hInst, void* hInstPrev, char* cmdline, int cmdshow) { return app_main(__argc, __argv); } int app_main(__VA_ARGS__)
         #endif // _WINBASE_
     #endif // __cplusplus
 #endif
 
-#endif // WINMAIN_H
\ No newline at end of file
+#endif // WINMAIN_H
@@ -58,6 +58,8 @@
 //#define SUPPORT_BUSY_WAIT_LOOP          1
 // Use a partial-busy wait loop, in this case frame sleeps for most of the time, but then runs a busy loop at the end for accuracy
 #define SUPPORT_PARTIALBUSY_WAIT_LOOP    1
+// Linux: wait for frames against absolute deadlines, clock_nanosleep(TIMER_ABSTIME) and a short busy wait with an adaptive margin
+#define SUPPORT_DEADLINE_FRAME_PACING    1
 // Allow automatic screen capture of current screen pressing F12, defined in KeyCallback()
 #define SUPPORT_SCREEN_CAPTURE          1
 // Allow automatic gif recording of current screen pressing CTRL+F12, defined in KeyCallback()
@@ -87,7 +89,8 @@
 
 #define MAX_DECOMPRESSION_SIZE         64       // Max size allocated for decompression in MB
 
-#define MAX_AUTOMATION_EVENTS       16384       // Maximum number of automation events to record
+#define AUTOMATION_EVENTS_CAPACITY   1024       // Initial capacity of a new automation events list, it grows while recording
+#define AUTOMATION_CHUNK_EVENTS      4096       // Automation events per chunk of a binary events file (and per streamed write)
 
 //------------------------------------------------------------------------------------
 // Module: rlgl - Configuration values
@@ -99,8 +102,16 @@
 // Show OpenGL extensions and capabilities detailed logs on init
 //#define RLGL_SHOW_GL_DETAILS_INFO              1
 
+// Store XY positions and 16 bit texcoords in the render batches, Breakout draws nothing in 3D
+#define RLGL_BATCH_VERTEX_2D                   1
+
+// Orphan the render batch buffers before uploading, WebGL reallocates them instead
+#if !defined(PLATFORM_WEB)
+    #define RLGL_BATCH_ORPHAN_BUFFERS          1
+#endif
+
 //#define RL_DEFAULT_BATCH_BUFFER_ELEMENTS    4096    // Default internal render batch elements limits
-#define RL_DEFAULT_BATCH_BUFFERS               1      // Default number of batch buffers (multi-buffering)
+#define RL_DEFAULT_BATCH_BUFFERS               3      // Default number of batch buffers (multi-buffering)
 #define RL_DEFAULT_BATCH_DRAWCALLS           256      // Default number of batch draw calls (by state changes: mode, texture)
 #define RL_DEFAULT_BATCH_MAX_TEXTURE_UNITS     4      // Maximum number of textures units that can be activated on batch drawing (SetShaderValueTexture())
 
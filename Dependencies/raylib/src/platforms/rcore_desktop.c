@@ -94,11 +94,16 @@
     #define GLFW_MOUSE_PASSTHROUGH      0x0002000D
 #endif
 
+#ifndef EVENT_WAITING_GAMEPAD_TIMEOUT
+    #define EVENT_WAITING_GAMEPAD_TIMEOUT   0.05    // Seconds waited for events at most while a gamepad is connected
+#endif
+
 //----------------------------------------------------------------------------------
 // Types and Structures Definition
 //----------------------------------------------------------------------------------
 typedef struct {
     GLFWwindow *handle;                 // GLFW window handle (graphic device)
+    bool inputBegun;                    // Input states of the new frame registered, WaitInputEvents() was called
 } PlatformData;
 
 //----------------------------------------------------------------------------------
@@ -1094,8 +1099,8 @@ void SetMouseCursor(int cursor)
     }
 }
 
-// Register all input events
-void PollInputEvents(void)
+// Register the previous input states of a new frame, events after it belong to the new frame
+static void BeginInputEvents(void)
 {
 #if defined(SUPPORT_GESTURES_SYSTEM)
     // NOTE: Gestures update must be called every frame to reset gestures correctly
@@ -1222,8 +1227,46 @@ void PollInputEvents(void)
     }
 
     CORE.Window.resizedLastFrame = false;
+    CORE.Input.Timed.count = 0;
+    platform.inputBegun = true;
+}
+
+#if defined(FRAME_PACING_DEADLINE)
+// Process the pending input events without waiting
+// NOTE: Used around the frame deadline sleep, the events of the next frame get their real time instead of the time of PollInputEvents()
+static void ProcessInputEvents(void)
+{
+    if (!platform.inputBegun) BeginInputEvents();
+
+    glfwPollEvents();
+}
+#elif !defined(SUPPORT_BUSY_WAIT_LOOP) && !defined(SUPPORT_CUSTOM_FRAME_CONTROL)
+// Wait for input events, processing them as they arrive
+// NOTE: Used while frames wait, the events of the next frame get their real time instead of the time of PollInputEvents()
+static void WaitInputEvents(double timeout)
+{
+    if (!platform.inputBegun) BeginInputEvents();
+
+    glfwWaitEventsTimeout(timeout);
+}
+#endif
+
+// Register all input events
+void PollInputEvents(void)
+{
+    if (!platform.inputBegun) BeginInputEvents();
+    platform.inputBegun = false;
 
-    if (CORE.Window.eventWaiting) glfwWaitEvents();     // Wait for in input events before continue (drawing is paused)
+    if (CORE.Window.eventWaiting)
+    {
+        // Wait for in input events before continue (drawing is paused)
+        // NOTE: Gamepads are polled above, they don't send events that end the wait
+        bool gamepadReady = false;
+        for (int i = 0; i < MAX_GAMEPADS; i++) gamepadReady = gamepadReady || CORE.Input.Gamepad.ready[i];
+
+        if (gamepadReady) glfwWaitEventsTimeout(EVENT_WAITING_GAMEPAD_TIMEOUT);
+        else glfwWaitEvents();
+    }
     else glfwPollEvents();      // Poll input events: keyboard/mouse/window events (callbacks) -> Update keys state
 
     // While window minimized, stop loop execution
@@ -1698,6 +1741,8 @@ static void KeyCallback(GLFWwindow *window, int key, int scancode, int action, i
     else if(action == GLFW_PRESS) CORE.Input.Keyboard.currentKeyState[key] = 1;
     else if(action == GLFW_REPEAT) CORE.Input.Keyboard.keyRepeatInFrame[key] = 1;
 
+    if (action != GLFW_REPEAT) AddTimedInputEvent((action == GLFW_PRESS)? TIMED_INPUT_KEY_DOWN : TIMED_INPUT_KEY_UP, key, (Vector2){ 0 });
+
     // WARNING: Check if CAPS/NUM key modifiers are enabled and force down state for those keys
     if (((key == KEY_CAPS_LOCK) && ((mods & GLFW_MOD_CAPS_LOCK) > 0)) ||
         ((key == KEY_NUM_LOCK) && ((mods & GLFW_MOD_NUM_LOCK) > 0))) CORE.Input.Keyboard.currentKeyState[key] = 1;
@@ -1775,6 +1820,8 @@ static void MouseCursorPosCallback(GLFWwindow *window, double x, double y)
     CORE.Input.Mouse.currentPosition.y = (float)y;
     CORE.Input.Touch.position[0] = CORE.Input.Mouse.currentPosition;
 
+    AddTimedInputEvent(TIMED_INPUT_MOUSE_MOVE, 0, GetMousePosition());
+
 #if defined(SUPPORT_GESTURES_SYSTEM) && defined(SUPPORT_MOUSE_GESTURES)
     // Process mouse events as touches to be able to use mouse-gestures
     GestureEvent gestureEvent = { 0 };
@@ -180,6 +180,8 @@ typedef struct tagBITMAPINFOHEADER {
 #include <stdio.h>                      // Required for: FILE, fopen(), fclose(), fread()
 #include <string.h>                     // Required for: strcmp() [Used in IsFileExtension(), LoadWaveFromMemory(), LoadMusicStreamFromMemory()]
 
+#include "rtrace.h"                     // Required for: RL_ZONE_BEGIN(), RL_ZONE_END()
+
 #if defined(RAUDIO_STANDALONE)
     #ifndef TRACELOG
         #define TRACELOG(level, ...)    printf(__VA_ARGS__)
@@ -755,6 +757,7 @@ Wave LoadWave(const char *fileName)
 // WARNING: File extension must be provided in lower-case
 Wave LoadWaveFromMemory(const char *fileType, const unsigned char *fileData, int dataSize)
 {
+    RL_ZONE_BEGIN("LoadWaveFromMemory");
     Wave wave = { 0 };
 
     if (false) { }
@@ -858,6 +861,7 @@ Wave LoadWaveFromMemory(const char *fileType, const unsigned char *fileData, int
 
     TRACELOG(LOG_INFO, "WAVE: Data loaded successfully (%i Hz, %i bit, %i channels)", wave.sampleRate, wave.sampleSize, wave.channels);
 
+    RL_ZONE_END();
     return wave;
 }
 
@@ -2474,6 +2478,7 @@ static ma_uint32 ReadAudioBufferFramesInMixingFormat(AudioBuffer *audioBuffer, f
 static void OnSendAudioDataToDevice(ma_device *pDevice, void *pFramesOut, const void *pFramesInput, ma_uint32 frameCount)
 {
     (void)pDevice;
+    RL_ZONE_BEGIN("OnSendAudioDataToDevice");     // Runs on the audio thread, it gets its own track in the trace
 
     // Mixing is basically just an accumulation, we need to initialize the output buffer to 0
     memset(pFramesOut, 0, frameCount*pDevice->playback.channels*ma_get_bytes_per_sample(pDevice->playback.format));
@@ -2565,6 +2570,7 @@ static void OnSendAudioDataToDevice(ma_device *pDevice, void *pFramesOut, const
     }
 
     ma_mutex_unlock(&AUDIO.System.lock);
+    RL_ZONE_END();
 }
 
 // Main mixing function, pretty simple in this project, just an accumulation
@@ -506,6 +506,31 @@ typedef struct FilePathList {
     char **paths;                   // Filepaths entries
 } FilePathList;
 
+// Frame phase times, measured by EndDrawing()
+typedef struct FramePhaseTimes {
+    double drawBatch;               // rlDrawRenderBatchActive(), submitting the draw calls of the frame
+    double swapBuffers;             // SwapScreenBuffer()
+    double wait;                    // WaitTime() of the target FPS, 0 if not waited
+    double pollEvents;              // PollInputEvents()
+} FramePhaseTimes;
+
+// Frame pacing stats of the last frames, only measured with SUPPORT_DEADLINE_FRAME_PACING (Linux)
+typedef struct FramePacingStats {
+    double jitterAvg;               // Frame start after its deadline, average in seconds
+    double jitterMax;               // Frame start after its deadline, maximum in seconds
+    double spinAvg;                 // Busy waited time per frame, average in seconds
+    double spinMargin;              // Time before a deadline the sleep ends, adapts to the oversleeping of the system
+    unsigned int missed;            // Frames that took longer than the target time, since InitWindow()
+} FramePacingStats;
+
+// Timed input event, queued as the platform processes input (desktop only)
+typedef struct TimedInputEvent {
+    double time;                    // GetTime() of the event, input is processed while frames wait, within the frame
+    int type;                       // Event type (TimedInputEventType)
+    int key;                        // Key of key events
+    Vector2 position;               // Mouse position of mouse move events, like GetMousePosition()
+} TimedInputEvent;
+
 // Automation event
 typedef struct AutomationEvent {
     unsigned int frame;             // Event frame
@@ -515,11 +540,21 @@ typedef struct AutomationEvent {
 
 // Automation event list
 typedef struct AutomationEventList {
-    unsigned int capacity;          // Events max entries (MAX_AUTOMATION_EVENTS)
+    unsigned int capacity;          // Events allocated entries, grows while recording
     unsigned int count;             // Events entries count
     AutomationEvent *events;        // Events entries
 } AutomationEventList;
 
+// Automation events playback, a binary events file mapped into memory and decoded one event at a time
+typedef struct AutomationEventPlayback {
+    unsigned char *data;            // Mapped file data (NULL if the file could not be loaded)
+    unsigned int dataSize;          // Mapped file data size
+    unsigned int offset;            // Data offset of the next event
+    unsigned int chunkEnd;          // Data offset of the end of the current chunk
+    unsigned int chunkEvents;       // Events left in the current chunk
+    unsigned int frame;             // Frame of the last event read
+} AutomationEventPlayback;
+
 //----------------------------------------------------------------------------------
 // Enumerators Definition
 //----------------------------------------------------------------------------------
@@ -741,6 +776,13 @@ typedef enum {
     GAMEPAD_AXIS_RIGHT_TRIGGER = 5      // Gamepad back trigger right, pressure level: [1..-1]
 } GamepadAxis;
 
+// Timed input event types
+typedef enum {
+    TIMED_INPUT_KEY_DOWN = 0,           // Key pressed, not repeated
+    TIMED_INPUT_KEY_UP,                 // Key released
+    TIMED_INPUT_MOUSE_MOVE              // Mouse moved
+} TimedInputEventType;
+
 // Material map index
 typedef enum {
     MATERIAL_MAP_ALBEDO = 0,        // Albedo material (same as: MATERIAL_MAP_DIFFUSE)
@@ -1056,6 +1098,8 @@ RLAPI Vector2 GetWorldToScreen2D(Vector2 position, Camera2D camera); // Get the
 // Timing-related functions
 RLAPI void SetTargetFPS(int fps);                                 // Set target FPS (maximum)
 RLAPI float GetFrameTime(void);                                   // Get time in seconds for last frame drawn (delta time)
+RLAPI FramePhaseTimes GetFramePhaseTimes(void);                   // Get time in seconds of the EndDrawing() phases of the last frame
+RLAPI FramePacingStats GetFramePacingStats(void);                 // Get frame pacing stats of the last frames (deadline pacing only)
 RLAPI double GetTime(void);                                       // Get elapsed time in seconds since InitWindow()
 RLAPI int GetFPS(void);                                           // Get current FPS
 
@@ -1133,14 +1177,19 @@ RLAPI char *EncodeDataBase64(const unsigned char *data, int dataSize, int *outpu
 RLAPI unsigned char *DecodeDataBase64(const unsigned char *data, int *outputSize);                    // Decode Base64 string data, memory must be MemFree()
 
 // Automation events functionality
-RLAPI AutomationEventList LoadAutomationEventList(const char *fileName);                // Load automation events list from file, NULL for empty list, capacity = MAX_AUTOMATION_EVENTS
+RLAPI AutomationEventList LoadAutomationEventList(const char *fileName);                // Load automation events list from file (binary or text), NULL for empty list
 RLAPI void UnloadAutomationEventList(AutomationEventList *list);                        // Unload automation events list from file
-RLAPI bool ExportAutomationEventList(AutomationEventList list, const char *fileName);   // Export automation events list as text file
+RLAPI bool ExportAutomationEventList(AutomationEventList list, const char *fileName);   // Export automation events list as binary file, as text file for .txt
 RLAPI void SetAutomationEventList(AutomationEventList *list);                           // Set automation event list to record to
 RLAPI void SetAutomationEventBaseFrame(int frame);                                      // Set automation event internal base frame to start recording
 RLAPI void StartAutomationEventRecording(void);                                         // Start recording automation events (AutomationEventList must be set)
 RLAPI void StopAutomationEventRecording(void);                                          // Stop recording automation events
+RLAPI bool StartAutomationEventStream(const char *fileName);                            // Stream recorded events to a binary file in the background (AutomationEventList must be set, streamed events are removed from it)
+RLAPI void StopAutomationEventStream(void);                                             // Write the remaining events and close the stream
 RLAPI void PlayAutomationEvent(AutomationEvent event);                                  // Play a recorded automation event
+RLAPI AutomationEventPlayback LoadAutomationEventPlayback(const char *fileName);        // Map a binary automation events file for playback, nothing is decoded up front
+RLAPI void UnloadAutomationEventPlayback(AutomationEventPlayback *playback);             // Unmap automation events playback file
+RLAPI bool ReadAutomationEvent(AutomationEventPlayback *playback, AutomationEvent *event); // Read the next event of the playback, false at the end of the file
 
 //------------------------------------------------------------------------------------
 // Input Handling Functions (Module: core)
@@ -1154,6 +1203,7 @@ RLAPI bool IsKeyReleased(int key);                            // Check if a key
 RLAPI bool IsKeyUp(int key);                                  // Check if a key is NOT being pressed
 RLAPI int GetKeyPressed(void);                                // Get key pressed (keycode), call it multiple times for keys queued, returns 0 when the queue is empty
 RLAPI int GetCharPressed(void);                               // Get char pressed (unicode), call it multiple times for chars queued, returns 0 when the queue is empty
+RLAPI const TimedInputEvent *GetTimedInputEvents(int *count);  // Get the key and mouse move events since the last frame with their time, in order (Only PLATFORM_DESKTOP)
 RLAPI void SetExitKey(int key);                               // Set a custom key to exit program (default is ESC)
 
 // Input-related functions: gamepads
@@ -1240,6 +1290,7 @@ RLAPI void DrawRectangle(int posX, int posY, int width, int height, Color color)
 RLAPI void DrawRectangleV(Vector2 position, Vector2 size, Color color);                                  // Draw a color-filled rectangle (Vector version)
 RLAPI void DrawRectangleRec(Rectangle rec, Color color);                                                 // Draw a color-filled rectangle
 RLAPI void DrawRectanglePro(Rectangle rec, Vector2 origin, float rotation, Color color);                 // Draw a color-filled rectangle with pro parameters
+RLAPI void DrawRectanglesBatch(const Rectangle *recs, const Color *colors, int count);                   // Draw many color-filled rectangles, written straight into the render batch
 RLAPI void DrawRectangleGradientV(int posX, int posY, int width, int height, Color color1, Color color2);// Draw a vertical-gradient-filled rectangle
 RLAPI void DrawRectangleGradientH(int posX, int posY, int width, int height, Color color1, Color color2);// Draw a horizontal-gradient-filled rectangle
 RLAPI void DrawRectangleGradientEx(Rectangle rec, Color col1, Color col2, Color col3, Color col4);       // Draw a gradient-filled rectangle with custom vertex colors
@@ -1278,6 +1329,7 @@ RLAPI Vector2 GetSplinePointBezierCubic(Vector2 p1, Vector2 c2, Vector2 c3, Vect
 RLAPI bool CheckCollisionRecs(Rectangle rec1, Rectangle rec2);                                           // Check collision between two rectangles
 RLAPI bool CheckCollisionCircles(Vector2 center1, float radius1, Vector2 center2, float radius2);        // Check collision between two circles
 RLAPI bool CheckCollisionCircleRec(Vector2 center, float radius, Rectangle rec);                         // Check collision between circle and rectangle
+RLAPI bool CheckCollisionCircleRecs(Vector2 center, float radius, const float *xs, const float *ys, const float *widths, const float *heights, int count, unsigned long long *hitMask); // Check collision between circle and rectangles (SIMD), sets bit i of hitMask if rectangle i collides
 RLAPI bool CheckCollisionPointRec(Vector2 point, Rectangle rec);                                         // Check if point is inside rectangle
 RLAPI bool CheckCollisionPointCircle(Vector2 point, Vector2 center, float radius);                       // Check if point is inside circle
 RLAPI bool CheckCollisionPointTriangle(Vector2 point, Vector2 p1, Vector2 p2, Vector2 p3);               // Check if point is inside a triangle
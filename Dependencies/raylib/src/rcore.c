@@ -41,6 +41,10 @@
 *       #define SUPPORT_PARTIALBUSY_WAIT_LOOP
 *           Use a partial-busy wait loop, in this case frame sleeps for most of the time and runs a busy-wait-loop at the end
 *
+*       #define SUPPORT_DEADLINE_FRAME_PACING
+*           Linux: frames wait for absolute deadlines (clock_nanosleep(TIMER_ABSTIME)), the busy wait only covers
+*           the oversleeping measured on the system, errors don't carry over into the next frame
+*
 *       #define SUPPORT_SCREEN_CAPTURE
 *           Allow automatic screen capture of current screen pressing F12, defined in KeyCallback()
 *
@@ -97,6 +101,9 @@
 #include <time.h>                   // Required for: time() [Used in InitTimer()]
 #include <math.h>                   // Required for: tan() [Used in BeginMode3D()], atan2f() [Used in LoadVrStereoConfig()]
 
+#define RTRACE_IMPLEMENTATION
+#include "rtrace.h"                 // Trace zones, compiled out unless RL_TRACE_ZONES is defined
+
 #define RLGL_IMPLEMENTATION
 #include "rlgl.h"                   // OpenGL abstraction layer to OpenGL 1.1, 3.3+ or ES2
 
@@ -182,6 +189,43 @@ __declspec(dllimport) int __stdcall WideCharToMultiByte(unsigned int cp, unsigne
     #define CHDIR chdir
 #endif
 
+#if defined(SUPPORT_AUTOMATION_EVENTS)
+    #if defined(_WIN32)
+// NOTE: We declare the required symbols to avoid including windows.h (kernel32.lib linkage required)
+// Used to stream automation events files from a background thread and to map them for loading
+__declspec(dllimport) void *__stdcall CreateThread(void *attributes, size_t stackSize, unsigned long (__stdcall *start)(void *), void *param, unsigned long flags, unsigned long *threadId);
+__declspec(dllimport) unsigned long __stdcall WaitForSingleObject(void *handle, unsigned long milliseconds);
+__declspec(dllimport) int __stdcall CloseHandle(void *handle);
+__declspec(dllimport) void __stdcall InitializeSRWLock(void **lock);
+__declspec(dllimport) void __stdcall AcquireSRWLockExclusive(void **lock);
+__declspec(dllimport) void __stdcall ReleaseSRWLockExclusive(void **lock);
+__declspec(dllimport) void __stdcall InitializeConditionVariable(void **condition);
+__declspec(dllimport) int __stdcall SleepConditionVariableSRW(void **condition, void **lock, unsigned long milliseconds, unsigned long flags);
+__declspec(dllimport) void __stdcall WakeConditionVariable(void **condition);
+__declspec(dllimport) void *__stdcall CreateFileA(const char *fileName, unsigned long access, unsigned long shareMode, void *attributes, unsigned long disposition, unsigned long flags, void *templateFile);
+__declspec(dllimport) int __stdcall GetFileSizeEx(void *file, long long *size);
+__declspec(dllimport) void *__stdcall CreateFileMappingA(void *file, void *attributes, unsigned long protect, unsigned long sizeHigh, unsigned long sizeLow, const char *name);
+__declspec(dllimport) void *__stdcall MapViewOfFile(void *mapping, unsigned long access, unsigned long offsetHigh, unsigned long offsetLow, size_t size);
+__declspec(dllimport) int __stdcall UnmapViewOfFile(const void *address);
+        #define AUTOMATION_STREAM_THREAD
+        #define AUTOMATION_MAP_FILE
+    #else
+        #if !defined(PLATFORM_WEB) || defined(__EMSCRIPTEN_PTHREADS__)
+            #include <pthread.h>        // Required for: pthread_create() [Used in StartAutomationEventStream()]
+            #define AUTOMATION_STREAM_THREAD
+        #endif
+        #if !defined(PLATFORM_WEB)
+            #include <sys/mman.h>       // Required for: mmap() [Used in LoadAutomationEventList()]
+            #include <fcntl.h>          // Required for: open()
+            #define AUTOMATION_MAP_FILE
+        #endif
+    #endif
+#endif
+
+#if defined(SUPPORT_DEADLINE_FRAME_PACING) && defined(__linux__)
+    #include <errno.h>                  // Required for: EINTR [Used in SleepUntil()]
+#endif
+
 //----------------------------------------------------------------------------------
 // Defines and Macros
 //----------------------------------------------------------------------------------
@@ -221,14 +265,30 @@ __declspec(dllimport) int __stdcall WideCharToMultiByte(unsigned int cp, unsigne
     #define MAX_CHAR_PRESSED_QUEUE        16        // Maximum number of characters in the char input queue
 #endif
 
+#ifndef MAX_TIMED_INPUT_EVENTS
+    #define MAX_TIMED_INPUT_EVENTS       256        // Maximum number of timed input events per frame, mouse moves are merged when full
+#endif
+
 #ifndef MAX_DECOMPRESSION_SIZE
     #define MAX_DECOMPRESSION_SIZE        64        // Maximum size allocated for decompression in MB
 #endif
 
-#ifndef MAX_AUTOMATION_EVENTS
-    #define MAX_AUTOMATION_EVENTS      16384        // Maximum number of automation events to record
+#ifndef AUTOMATION_EVENTS_CAPACITY
+    #define AUTOMATION_EVENTS_CAPACITY  1024        // Initial capacity of a new automation events list, it grows while recording
+#endif
+#ifndef AUTOMATION_CHUNK_EVENTS
+    #define AUTOMATION_CHUNK_EVENTS     4096        // Automation events per chunk of a binary events file (and per streamed write)
 #endif
 
+#if defined(SUPPORT_DEADLINE_FRAME_PACING) && defined(__linux__) && !defined(SUPPORT_BUSY_WAIT_LOOP) && !defined(SUPPORT_CUSTOM_FRAME_CONTROL)
+    #define FRAME_PACING_DEADLINE
+#endif
+#ifndef FRAME_PACING_STATS_FRAMES
+    #define FRAME_PACING_STATS_FRAMES    120        // Frames the pacing stats are measured over
+#endif
+#define FRAME_PACING_MIN_MARGIN        50000        // Spin margin limits in nanoseconds
+#define FRAME_PACING_MAX_MARGIN      4000000
+
 // Flags operation macros
 #define FLAG_SET(n, f) ((n) |= (f))
 #define FLAG_CLEAR(n, f) ((n) &= ~(f))
@@ -328,6 +388,11 @@ typedef struct CoreData {
             float axisState[MAX_GAMEPADS][MAX_GAMEPAD_AXIS];                // Gamepad axis state
 
         } Gamepad;
+        struct {
+            TimedInputEvent events[MAX_TIMED_INPUT_EVENTS];     // Key and mouse move events since the last frame
+            int count;                                          // Events count
+
+        } Timed;
     } Input;
     struct {
         double current;                     // Current time measure
@@ -338,6 +403,19 @@ typedef struct CoreData {
         double target;                      // Desired time for one frame, if 0 not applied
         unsigned long long int base;        // Base time measure for hi-res timer (PLATFORM_ANDROID, PLATFORM_DRM)
         unsigned int frameCounter;          // Frame counter
+        FramePhaseTimes phases;             // Time measures of the EndDrawing() phases of the last frame
+#if defined(FRAME_PACING_DEADLINE)
+        struct {
+            unsigned long long int deadline;    // CLOCK_MONOTONIC time the next frame starts at, nanoseconds
+            unsigned long long int period;      // Target time for one frame, the deadlines restart when it changes
+            unsigned long long int margin;      // Time before the deadline the sleep ends, the rest is busy waited
+            unsigned int missed;                // Frames that ended after their deadline
+            unsigned int index;                 // Next slot of the stats ring buffers
+            unsigned int count;                 // Frames in the stats ring buffers
+            unsigned int lateness[FRAME_PACING_STATS_FRAMES];   // Frame start after its deadline, nanoseconds
+            unsigned int spin[FRAME_PACING_STATS_FRAMES];       // Busy waited time, nanoseconds
+        } Pacing;
+#endif
 
     } Time;
 } CoreData;
@@ -443,6 +521,50 @@ struct AutomationEvent {
 
 static AutomationEventList *currentEventList = NULL;        // Current automation events list, set by user, keep internal pointer
 static bool automationEventRecording = false;               // Recording automation events flag
+static unsigned int automationEventsRecorded = 0;           // Events recorded since recording started, for the log
+static int automationAxisState[MAX_GAMEPADS][MAX_GAMEPAD_AXIS] = { 0 }; // Gamepad axis values last recorded
+static char automationButtonsPlayed[MAX_GAMEPADS][MAX_GAMEPAD_BUTTONS] = { 0 }; // Gamepad buttons held down by played events
+static int automationAxisPlayed[MAX_GAMEPADS][MAX_GAMEPAD_AXIS] = { 0 }; // Gamepad axis values of played events
+static bool automationGamepadPlayed = false;                // Gamepad events were played, their state is kept over the polled one
+
+// Encoded chunk of a binary automation events file, queued for the stream writer
+typedef struct AutomationChunk {
+    struct AutomationChunk *next;
+    unsigned int size;                  // Bytes of data, including the chunk header
+    unsigned char data[];
+} AutomationChunk;
+
+// Automation events stream, writes chunks of recorded events to a file in the background
+typedef struct AutomationStream {
+    FILE *file;                         // NULL if not streaming
+    unsigned int streamed;              // Events encoded into chunks, they are removed from currentEventList
+    AutomationChunk *first;             // Chunks waiting to be written
+    AutomationChunk *last;
+    bool quit;
+#if defined(_WIN32)
+    void *thread;
+    void *lock;                         // SRWLOCK
+    void *wake;                         // CONDITION_VARIABLE
+#elif defined(AUTOMATION_STREAM_THREAD)
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+#endif
+} AutomationStream;
+
+static AutomationStream automationStream = { 0 };          // Automation events stream, see StartAutomationEventStream()
+
+#if defined(_WIN32)
+    #define AUTOMATION_STREAM_LOCK()    AcquireSRWLockExclusive(&automationStream.lock)
+    #define AUTOMATION_STREAM_UNLOCK()  ReleaseSRWLockExclusive(&automationStream.lock)
+    #define AUTOMATION_STREAM_WAIT()    SleepConditionVariableSRW(&automationStream.wake, &automationStream.lock, 0xFFFFFFFF, 0)
+    #define AUTOMATION_STREAM_WAKE()    WakeConditionVariable(&automationStream.wake)
+#elif defined(AUTOMATION_STREAM_THREAD)
+    #define AUTOMATION_STREAM_LOCK()    pthread_mutex_lock(&automationStream.lock)
+    #define AUTOMATION_STREAM_UNLOCK()  pthread_mutex_unlock(&automationStream.lock)
+    #define AUTOMATION_STREAM_WAIT()    pthread_cond_wait(&automationStream.wake, &automationStream.lock)
+    #define AUTOMATION_STREAM_WAKE()    pthread_cond_signal(&automationStream.wake)
+#endif
 //static short automationEventEnabled = 0b0000001111111111; // TODO: Automation events enabled for recording/playing
 #endif
 //-----------------------------------------------------------------------------------
@@ -463,12 +585,46 @@ extern void ClosePlatform(void);        // Close platform
 static void InitTimer(void);                                // Initialize timer, hi-resolution if available (required by InitPlatform())
 static void SetupFramebuffer(int width, int height);        // Setup main framebuffer (required by InitPlatform())
 static void SetupViewport(int width, int height);           // Set viewport for a provided width and height
+#if defined(FRAME_PACING_DEADLINE)
+static unsigned long long int GetMonotonicTime(void);       // Get CLOCK_MONOTONIC time in nanoseconds
+static void SleepUntil(unsigned long long int time);        // Sleep until an absolute CLOCK_MONOTONIC time
+static void UpdateFramePacingMargin(unsigned long long int oversleep);  // Adapt the spin margin to the oversleeping of a sleep
+static void WaitFrameDeadline(void);                        // Wait for the deadline of the next frame (required by EndDrawing())
+#endif
+
+#if defined(PLATFORM_DESKTOP)
+static void AddTimedInputEvent(int type, int key, Vector2 position); // Queue a timed input event (used by the platform callbacks)
+#if defined(FRAME_PACING_DEADLINE)
+static void ProcessInputEvents(void);                       // Process the pending input events without waiting (platform specific)
+#endif
+#if !defined(FRAME_PACING_DEADLINE) && !defined(SUPPORT_BUSY_WAIT_LOOP) && !defined(SUPPORT_CUSTOM_FRAME_CONTROL)
+static void WaitInputEvents(double timeout);                // Wait for input events, processing them as they arrive (platform specific)
+static void WaitTimeProcessingInput(double seconds);        // Wait for some time, processing input events as they arrive
+#endif
+#endif
 
 static void ScanDirectoryFiles(const char *basePath, FilePathList *list, const char *filter);   // Scan all files and directories in a base path
 static void ScanDirectoryFilesRecursively(const char *basePath, FilePathList *list, const char *filter);  // Scan all files and directories recursively from a base path
 
 #if defined(SUPPORT_AUTOMATION_EVENTS)
 static void RecordAutomationEvent(void); // Record frame events (to internal events array)
+#if !defined(SUPPORT_CUSTOM_FRAME_CONTROL)
+static void KeepAutomationGamepadState(void); // Put the state of played gamepad events back over the polled one
+#endif
+static bool ReserveAutomationEvents(AutomationEventList *list, unsigned int count); // Grow events list capacity to hold count events
+static void StreamAutomationEvents(bool flush); // Hand recorded events to the stream writer, in full chunks unless flushing
+static void WriteAutomationU32(unsigned char *data, unsigned int value); // Write little endian u32 to automation events data
+static unsigned int ReadAutomationU32(const unsigned char *data); // Read little endian u32 of automation events data
+static AutomationChunk *EncodeAutomationChunk(const AutomationEvent *events, unsigned int count); // Encode events into one chunk of a binary events file
+static bool DecodeAutomationEvents(const unsigned char *data, unsigned int dataSize, AutomationEventList *list); // Decode a binary events file into list
+static bool DecodeAutomationEvent(const unsigned char *data, unsigned int end, unsigned int *offset, unsigned int *frame, AutomationEvent *event); // Decode one event of a chunk
+static unsigned char *MapFileData(const char *fileName, unsigned int *dataSize); // Map a file into memory read only
+static void UnmapFileData(unsigned char *data, unsigned int dataSize); // Unmap file data mapped with MapFileData()
+#if defined(_WIN32)
+static unsigned long __stdcall AutomationStreamThread(void *param); // Stream writer thread
+#elif defined(AUTOMATION_STREAM_THREAD)
+static void *AutomationStreamThread(void *param); // Stream writer thread
+#endif
 #endif
 
 #if defined(_WIN32)
@@ -817,6 +973,7 @@ void BeginDrawing(void)
 {
     // WARNING: Previously to BeginDrawing() other render textures drawing could happen,
     // consequently the measure for update vs draw is not accurate (only the total frame time is accurate)
+    RL_ZONE_BEGIN("BeginDrawing");
 
     CORE.Time.current = GetTime();      // Number of elapsed seconds since InitTimer()
     CORE.Time.update = CORE.Time.current - CORE.Time.previous;
@@ -827,12 +984,17 @@ void BeginDrawing(void)
 
     //rlTranslatef(0.375, 0.375, 0);    // HACK to have 2D pixel-perfect drawing on OpenGL 1.1
                                         // NOTE: Not required with OpenGL 3.3+
+
+    RL_ZONE_END();
 }
 
 // End canvas drawing and swap buffers (double buffering)
 void EndDrawing(void)
 {
+    RL_ZONE_BEGIN("EndDrawing");
+    double phaseStart = GetTime();
     rlDrawRenderBatchActive();      // Update and draw internal render batch
+    CORE.Time.phases.drawBatch = GetTime() - phaseStart;
 
 #if defined(SUPPORT_GIF_RECORDING)
     // Draw record indicator
@@ -865,33 +1027,66 @@ void EndDrawing(void)
     }
 #endif
 
+    rlResetFrameStats();            // Everything drawn from here on counts to the next frame
+
 #if defined(SUPPORT_AUTOMATION_EVENTS)
-    if (automationEventRecording) RecordAutomationEvent();    // Event recording
+    if (automationEventRecording)
+    {
+        RecordAutomationEvent();    // Event recording
+        if (automationStream.file != NULL) StreamAutomationEvents(false);   // Full chunks only, written in the background
+    }
 #endif
 
 #if !defined(SUPPORT_CUSTOM_FRAME_CONTROL)
+    phaseStart = GetTime();
+    RL_ZONE_BEGIN("SwapScreenBuffer");
     SwapScreenBuffer();                  // Copy back buffer to front buffer (screen)
+    RL_ZONE_END();
 
     // Frame time control system
     CORE.Time.current = GetTime();
+    CORE.Time.phases.swapBuffers = CORE.Time.current - phaseStart;
+    CORE.Time.phases.wait = 0.0;
     CORE.Time.draw = CORE.Time.current - CORE.Time.previous;
     CORE.Time.previous = CORE.Time.current;
 
     CORE.Time.frame = CORE.Time.update + CORE.Time.draw;
 
     // Wait for some milliseconds...
+#if defined(FRAME_PACING_DEADLINE)
+    if (CORE.Time.target > 0.0)         // Late frames as well, they restart the deadlines
+#else
     if (CORE.Time.frame < CORE.Time.target)
+#endif
     {
+#if defined(FRAME_PACING_DEADLINE)
+        RL_ZONE_BEGIN("WaitFrameDeadline");
+        WaitFrameDeadline();
+#elif defined(PLATFORM_DESKTOP) && !defined(SUPPORT_BUSY_WAIT_LOOP)
+        RL_ZONE_BEGIN("WaitTime");
+        WaitTimeProcessingInput(CORE.Time.target - CORE.Time.frame);
+#else
+        RL_ZONE_BEGIN("WaitTime");
         WaitTime(CORE.Time.target - CORE.Time.frame);
+#endif
+        RL_ZONE_END();
 
         CORE.Time.current = GetTime();
         double waitTime = CORE.Time.current - CORE.Time.previous;
         CORE.Time.previous = CORE.Time.current;
 
         CORE.Time.frame += waitTime;    // Total frame time: update + draw + wait
+        CORE.Time.phases.wait = waitTime;
     }
 
+    phaseStart = GetTime();
+    RL_ZONE_BEGIN("PollInputEvents");
     PollInputEvents();      // Poll user events (before next frame update)
+#if defined(SUPPORT_AUTOMATION_EVENTS)
+    if (automationGamepadPlayed) KeepAutomationGamepadState();
+#endif
+    RL_ZONE_END();
+    CORE.Time.phases.pollEvents = GetTime() - phaseStart;
 #endif
 
 #if defined(SUPPORT_SCREEN_CAPTURE)
@@ -933,6 +1128,7 @@ void EndDrawing(void)
 #endif  // SUPPORT_SCREEN_CAPTURE
 
     CORE.Time.frameCounter++;
+    RL_ZONE_END();
 }
 
 // Initialize 2D mode with custom camera (2D)
@@ -1616,6 +1812,43 @@ float GetFrameTime(void)
     return (float)CORE.Time.frame;
 }
 
+// Get time in seconds of the EndDrawing() phases of the last frame
+FramePhaseTimes GetFramePhaseTimes(void)
+{
+    return CORE.Time.phases;
+}
+
+// Get frame pacing stats of the last frames
+// NOTE: Only measured with deadline pacing, all zero otherwise
+FramePacingStats GetFramePacingStats(void)
+{
+    FramePacingStats stats = { 0 };
+
+#if defined(FRAME_PACING_DEADLINE)
+    unsigned long long int lateness = 0;
+    unsigned long long int spin = 0;
+    unsigned int latenessMax = 0;
+
+    for (unsigned int i = 0; i < CORE.Time.Pacing.count; i++)
+    {
+        lateness += CORE.Time.Pacing.lateness[i];
+        spin += CORE.Time.Pacing.spin[i];
+        if (CORE.Time.Pacing.lateness[i] > latenessMax) latenessMax = CORE.Time.Pacing.lateness[i];
+    }
+
+    if (CORE.Time.Pacing.count > 0)
+    {
+        stats.jitterAvg = (double)lateness/CORE.Time.Pacing.count/1e9;
+        stats.spinAvg = (double)spin/CORE.Time.Pacing.count/1e9;
+    }
+    stats.jitterMax = (double)latenessMax/1e9;
+    stats.spinMargin = (double)CORE.Time.Pacing.margin/1e9;
+    stats.missed = CORE.Time.Pacing.missed;
+#endif
+
+    return stats;
+}
+
 //----------------------------------------------------------------------------------
 // Module Functions Definition: Custom frame control
 //----------------------------------------------------------------------------------
@@ -2399,38 +2632,46 @@ unsigned char *DecodeDataBase64(const unsigned char *data, int *outputSize)
 // Module Functions Definition: Automation Events Recording and Playing
 //----------------------------------------------------------------------------------
 
-// Load automation events list from file, NULL for empty list, capacity = MAX_AUTOMATION_EVENTS
+// Binary automation events file, all values little endian:
+//    "rAEB", u32 version
+//    chunks of up to AUTOMATION_CHUNK_EVENTS events: u32 events count, u32 data size, data
+//    data per event: varint frame delta (to the previous event of the chunk, zigzag), varint type, 4 zigzag varint params
+// Chunks are independent, a file streamed during a session that crashed can be loaded up to the last complete chunk
+#define AUTOMATION_FILE_VERSION     1
+#define AUTOMATION_CHUNK_HEADER     8
+#define AUTOMATION_EVENT_MAX_SIZE   30      // 6 varints of at most 5 bytes
+
+// Load automation events list from file, NULL for empty list, the list grows while recording
+// NOTE: Binary files are memory mapped (if supported) and decoded at once, text files are still supported.
+// Use LoadAutomationEventPlayback() to play a long recording back without decoding it up front
 AutomationEventList LoadAutomationEventList(const char *fileName)
 {
     AutomationEventList list = { 0 };
 
-    // Allocate and empty automation event list, ready to record new events
-    list.events = (AutomationEvent *)RL_CALLOC(MAX_AUTOMATION_EVENTS, sizeof(AutomationEvent));
-    list.capacity = MAX_AUTOMATION_EVENTS;
-
 #if defined(SUPPORT_AUTOMATION_EVENTS)
-    if (fileName == NULL) TRACELOG(LOG_INFO, "AUTOMATION: New empty events list loaded successfully");
+    if (fileName == NULL)
+    {
+        // Allocate and empty automation event list, ready to record new events
+        ReserveAutomationEvents(&list, AUTOMATION_EVENTS_CAPACITY);
+        TRACELOG(LOG_INFO, "AUTOMATION: New empty events list loaded successfully");
+    }
     else
     {
         // Load automation events file (binary)
-        /*
-        //int dataSize = 0;
-        //unsigned char *data = LoadFileData(fileName, &dataSize);
-
-        FILE *raeFile = fopen(fileName, "rb");
-        unsigned char fileId[4] = { 0 };
+        unsigned int dataSize = 0;
+        unsigned char *data = MapFileData(fileName, &dataSize);
 
-        fread(fileId, 1, 4, raeFile);
-
-        if ((fileId[0] == 'r') && (fileId[1] == 'A') && (fileId[2] == 'E') && (fileId[1] == ' '))
+        if ((data != NULL) && (dataSize >= 8) && (memcmp(data, "rAEB", 4) == 0))
         {
-            fread(&eventCount, sizeof(int), 1, raeFile);
-            TRACELOG(LOG_WARNING, "Events loaded: %i\n", eventCount);
-            fread(events, sizeof(AutomationEvent), eventCount, raeFile);
+            if (DecodeAutomationEvents(data, dataSize, &list)) TRACELOG(LOG_INFO, "AUTOMATION: Events file loaded successfully");
+            else TRACELOG(LOG_WARNING, "AUTOMATION: Events file is truncated or corrupted, loaded the complete chunks");
+
+            UnmapFileData(data, dataSize);
+            TRACELOG(LOG_INFO, "AUTOMATION: Events loaded from file: %i", list.count);
+            return list;
         }
 
-        fclose(raeFile);
-        */
+        if (data != NULL) UnmapFileData(data, dataSize);
 
         // Load events file (text)
         //unsigned char *buffer = LoadFileText(fileName);
@@ -2448,9 +2689,15 @@ AutomationEventList LoadAutomationEventList(const char *fileName)
             {
                 switch (buffer[0])
                 {
-                    case 'c': sscanf(buffer, "c %i", &list.count); break;
+                    case 'c':
+                    {
+                        sscanf(buffer, "c %i", &list.count);
+                        ReserveAutomationEvents(&list, list.count);
+                    } break;
                     case 'e':
                     {
+                        if (!ReserveAutomationEvents(&list, counter + 1)) break;
+
                         sscanf(buffer, "e %d %d %d %d %d %d %[^\n]s", &list.events[counter].frame, &list.events[counter].type,
                                &list.events[counter].params[0], &list.events[counter].params[1], &list.events[counter].params[2], &list.events[counter].params[3], eventDesc);
 
@@ -2490,22 +2737,40 @@ void UnloadAutomationEventList(AutomationEventList *list)
 #endif
 }
 
-// Export automation events list as text file
+// Export automation events list as binary file, as text file if fileName ends with .txt
 bool ExportAutomationEventList(AutomationEventList list, const char *fileName)
 {
     bool success = false;
 
 #if defined(SUPPORT_AUTOMATION_EVENTS)
-    // Export events as binary file
-    // TODO: Save to memory buffer and SaveFileData()
-    /*
-    unsigned char fileId[4] = "rAE ";
-    FILE *raeFile = fopen(fileName, "wb");
-    fwrite(fileId, sizeof(unsigned char), 4, raeFile);
-    fwrite(&eventCount, sizeof(int), 1, raeFile);
-    fwrite(events, sizeof(AutomationEvent), eventCount, raeFile);
-    fclose(raeFile);
-    */
+    if (!IsFileExtension(fileName, ".txt"))
+    {
+        // Export events as binary file
+        FILE *raeFile = fopen(fileName, "wb");
+        if (raeFile == NULL)
+        {
+            TRACELOG(LOG_WARNING, "AUTOMATION: [%s] Failed to open file for export", fileName);
+            return false;
+        }
+
+        unsigned char header[8] = { 'r', 'A', 'E', 'B' };
+        WriteAutomationU32(header + 4, AUTOMATION_FILE_VERSION);
+        success = (fwrite(header, 1, sizeof(header), raeFile) == sizeof(header));
+
+        for (unsigned int i = 0; success && (i < list.count); i += AUTOMATION_CHUNK_EVENTS)
+        {
+            AutomationChunk *chunk = EncodeAutomationChunk(list.events + i, ((list.count - i) < AUTOMATION_CHUNK_EVENTS)? (list.count - i) : AUTOMATION_CHUNK_EVENTS);
+            success = (chunk != NULL) && (fwrite(chunk->data, 1, chunk->size, raeFile) == chunk->size);
+            RL_FREE(chunk);
+        }
+
+        success = (fclose(raeFile) == 0) && success;
+
+        if (success) TRACELOG(LOG_INFO, "AUTOMATION: [%s] Events file exported successfully: %i", fileName, list.count);
+        else TRACELOG(LOG_WARNING, "AUTOMATION: [%s] Failed to export events file", fileName);
+
+        return success;
+    }
 
     // Export events as text
     // TODO: Save to memory buffer and SaveFileText()
@@ -2560,6 +2825,8 @@ void StartAutomationEventRecording(void)
 {
 #if defined(SUPPORT_AUTOMATION_EVENTS)
     automationEventRecording = true;
+    automationEventsRecorded = 0;
+    memset(automationAxisState, 0, sizeof(automationAxisState));
 #endif
 }
 
@@ -2567,10 +2834,93 @@ void StartAutomationEventRecording(void)
 void StopAutomationEventRecording(void)
 {
 #if defined(SUPPORT_AUTOMATION_EVENTS)
+    if (automationEventRecording) TRACELOG(LOG_INFO, "AUTOMATION: Recording stopped, events recorded: %i", automationEventsRecorded);
+
     automationEventRecording = false;
 #endif
 }
 
+// Start streaming the events of the current list to a binary file, written in the background while recording
+// NOTE: Events already in the list are streamed too. Streamed events are removed from the list, so it stays small
+// in long sessions, the file holds the whole recording once the stream is stopped
+bool StartAutomationEventStream(const char *fileName)
+{
+#if defined(SUPPORT_AUTOMATION_EVENTS)
+    if ((currentEventList == NULL) || (automationStream.file != NULL))
+    {
+        TRACELOG(LOG_WARNING, "AUTOMATION: Stream requires an events list and no other running stream");
+        return false;
+    }
+
+    FILE *raeFile = fopen(fileName, "wb");
+    unsigned char header[8] = { 'r', 'A', 'E', 'B' };
+    WriteAutomationU32(header + 4, AUTOMATION_FILE_VERSION);
+    if ((raeFile == NULL) || (fwrite(header, 1, sizeof(header), raeFile) != sizeof(header)))
+    {
+        if (raeFile != NULL) fclose(raeFile);
+        TRACELOG(LOG_WARNING, "AUTOMATION: [%s] Failed to open file for streaming", fileName);
+        return false;
+    }
+
+    memset(&automationStream, 0, sizeof(AutomationStream));
+    automationStream.file = raeFile;
+
+#if defined(_WIN32)
+    InitializeSRWLock(&automationStream.lock);
+    InitializeConditionVariable(&automationStream.wake);
+    automationStream.thread = CreateThread(NULL, 0, AutomationStreamThread, NULL, 0, NULL);
+    bool threaded = (automationStream.thread != NULL);
+#elif defined(AUTOMATION_STREAM_THREAD)
+    pthread_mutex_init(&automationStream.lock, NULL);
+    pthread_cond_init(&automationStream.wake, NULL);
+    bool threaded = (pthread_create(&automationStream.thread, NULL, AutomationStreamThread, NULL) == 0);
+#else
+    bool threaded = false;
+#endif
+    // Without a writer thread the chunks are written when they are full, on the recording thread
+    if (!threaded) automationStream.quit = true;
+
+    TRACELOG(LOG_INFO, "AUTOMATION: [%s] Streaming events to file", fileName);
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Stop streaming automation events, writes the remaining events and closes the file
+void StopAutomationEventStream(void)
+{
+#if defined(SUPPORT_AUTOMATION_EVENTS)
+    if (automationStream.file == NULL) return;
+
+    StreamAutomationEvents(true);
+
+#if defined(AUTOMATION_STREAM_THREAD)
+    if (!automationStream.quit)
+    {
+        AUTOMATION_STREAM_LOCK();
+        automationStream.quit = true;
+        AUTOMATION_STREAM_WAKE();
+        AUTOMATION_STREAM_UNLOCK();
+
+    #if defined(_WIN32)
+        WaitForSingleObject(automationStream.thread, 0xFFFFFFFF);
+        CloseHandle(automationStream.thread);
+    #else
+        pthread_join(automationStream.thread, NULL);
+        pthread_cond_destroy(&automationStream.wake);
+        pthread_mutex_destroy(&automationStream.lock);
+    #endif
+    }
+#endif
+
+    if (fclose(automationStream.file) != 0) TRACELOG(LOG_WARNING, "AUTOMATION: Failed to close the events stream");
+    else TRACELOG(LOG_INFO, "AUTOMATION: Events stream closed, events streamed: %i", automationStream.streamed);
+
+    memset(&automationStream, 0, sizeof(AutomationStream));
+#endif
+}
+
 // Play a recorded automation event
 void PlayAutomationEvent(AutomationEvent event)
 {
@@ -2615,13 +2965,30 @@ void PlayAutomationEvent(AutomationEvent event)
                 CORE.Input.Touch.position[event.params[0]].x = (float)event.params[1];
                 CORE.Input.Touch.position[event.params[0]].y = (float)event.params[2];
             } break;
+            // NOTE: Gamepads are polled, the state of played gamepad events is kept until the matching up event (or centered axis)
             case INPUT_GAMEPAD_CONNECT: CORE.Input.Gamepad.ready[event.params[0]] = true; break;                // param[0]: gamepad
-            case INPUT_GAMEPAD_DISCONNECT: CORE.Input.Gamepad.ready[event.params[0]] = false; break;            // param[0]: gamepad
-            case INPUT_GAMEPAD_BUTTON_UP: CORE.Input.Gamepad.currentButtonState[event.params[0]][event.params[1]] = false; break;    // param[0]: gamepad, param[1]: button
-            case INPUT_GAMEPAD_BUTTON_DOWN: CORE.Input.Gamepad.currentButtonState[event.params[0]][event.params[1]] = true; break;   // param[0]: gamepad, param[1]: button
+            case INPUT_GAMEPAD_DISCONNECT:                                                                      // param[0]: gamepad
+            {
+                CORE.Input.Gamepad.ready[event.params[0]] = false;
+                memset(automationButtonsPlayed[event.params[0]], 0, sizeof(automationButtonsPlayed[0]));
+                memset(automationAxisPlayed[event.params[0]], 0, sizeof(automationAxisPlayed[0]));
+            } break;
+            case INPUT_GAMEPAD_BUTTON_UP:   // param[0]: gamepad, param[1]: button
+            {
+                CORE.Input.Gamepad.currentButtonState[event.params[0]][event.params[1]] = false;
+                automationButtonsPlayed[event.params[0]][event.params[1]] = false;
+            } break;
+            case INPUT_GAMEPAD_BUTTON_DOWN: // param[0]: gamepad, param[1]: button
+            {
+                CORE.Input.Gamepad.currentButtonState[event.params[0]][event.params[1]] = true;
+                automationButtonsPlayed[event.params[0]][event.params[1]] = true;
+                automationGamepadPlayed = true;
+            } break;
             case INPUT_GAMEPAD_AXIS_MOTION: // param[0]: gamepad, param[1]: axis, param[2]: delta
             {
                 CORE.Input.Gamepad.axisState[event.params[0]][event.params[1]] = ((float)event.params[2]/32768.0f);
+                automationAxisPlayed[event.params[0]][event.params[1]] = event.params[2];
+                automationGamepadPlayed = true;
             } break;
             case INPUT_GESTURE: GESTURES.current = event.params[0]; break;     // param[0]: gesture (enum Gesture) -> rgestures.h: GESTURES.current
 
@@ -2644,6 +3011,73 @@ void PlayAutomationEvent(AutomationEvent event)
 #endif
 }
 
+// Load automation events playback, a binary events file is mapped into memory (if supported) and nothing is decoded up front
+// NOTE: Loading takes the same time for any recording length, events are decoded as ReadAutomationEvent() reaches them
+AutomationEventPlayback LoadAutomationEventPlayback(const char *fileName)
+{
+    AutomationEventPlayback playback = { 0 };
+
+#if defined(SUPPORT_AUTOMATION_EVENTS)
+    playback.data = MapFileData(fileName, &playback.dataSize);
+
+    if ((playback.data == NULL) || (playback.dataSize < 8) || (memcmp(playback.data, "rAEB", 4) != 0) || (ReadAutomationU32(playback.data + 4) != AUTOMATION_FILE_VERSION))
+    {
+        if (playback.data != NULL) UnmapFileData(playback.data, playback.dataSize);
+        TRACELOG(LOG_WARNING, "AUTOMATION: [%s] Failed to load events file for playback, only binary files can be played back", fileName);
+        return (AutomationEventPlayback){ 0 };
+    }
+
+    playback.offset = 8;
+    playback.chunkEnd = 8;
+    TRACELOG(LOG_INFO, "AUTOMATION: [%s] Events file mapped for playback", fileName);
+#endif
+    return playback;
+}
+
+// Unload automation events playback
+void UnloadAutomationEventPlayback(AutomationEventPlayback *playback)
+{
+#if defined(SUPPORT_AUTOMATION_EVENTS)
+    if (playback->data != NULL) UnmapFileData(playback->data, playback->dataSize);
+#endif
+    *playback = (AutomationEventPlayback){ 0 };
+}
+
+// Read the next event of the playback, false at the end of the file or at a truncated or corrupted chunk
+bool ReadAutomationEvent(AutomationEventPlayback *playback, AutomationEvent *event)
+{
+#if defined(SUPPORT_AUTOMATION_EVENTS)
+    if (playback->data == NULL) return false;
+
+    // Next chunk, a chunk that doesn't fit in the file is where a streamed recording was cut off
+    while (playback->chunkEvents == 0)
+    {
+        if ((playback->offset != playback->chunkEnd) || ((playback->dataSize - playback->offset) < AUTOMATION_CHUNK_HEADER)) return false;
+
+        unsigned int count = ReadAutomationU32(playback->data + playback->offset);
+        unsigned int size = ReadAutomationU32(playback->data + playback->offset + 4);
+        playback->offset += AUTOMATION_CHUNK_HEADER;
+        if (size > (playback->dataSize - playback->offset)) return false;
+
+        playback->chunkEnd = playback->offset + size;
+        playback->chunkEvents = count;
+        playback->frame = 0;
+    }
+
+    if (!DecodeAutomationEvent(playback->data, playback->chunkEnd, &playback->offset, &playback->frame, event))
+    {
+        playback->chunkEvents = 0;
+        playback->offset = playback->dataSize;      // Nothing after a corrupted event can be trusted
+        return false;
+    }
+
+    playback->chunkEvents--;
+    return true;
+#else
+    return false;
+#endif
+}
+
 //----------------------------------------------------------------------------------
 // Module Functions Definition: Input Handling: Keyboard
 //----------------------------------------------------------------------------------
@@ -2714,6 +3148,14 @@ bool IsKeyUp(int key)
     return up;
 }
 
+// Get the key and mouse move events since the last frame with their time, in order
+// NOTE: The events stay valid until the next PollInputEvents()
+const TimedInputEvent *GetTimedInputEvents(int *count)
+{
+    *count = CORE.Input.Timed.count;
+    return CORE.Input.Timed.events;
+}
+
 // Get the last key pressed
 int GetKeyPressed(void)
 {
@@ -3057,9 +3499,150 @@ void InitTimer(void)
     else TRACELOG(LOG_WARNING, "TIMER: Hi-resolution timer not available");
 #endif
 
+#if defined(FRAME_PACING_DEADLINE)
+    // Calibrate the spin margin with a few short sleeps, frames keep adapting it
+    CORE.Time.Pacing.margin = FRAME_PACING_MIN_MARGIN;
+    for (int i = 0; i < 8; i++)
+    {
+        unsigned long long int wakeUp = GetMonotonicTime() + 250000;
+        SleepUntil(wakeUp);
+        unsigned long long int now = GetMonotonicTime();
+        UpdateFramePacingMargin((now > wakeUp)? now - wakeUp : 0);
+    }
+
+    TRACELOG(LOG_INFO, "TIMER: Deadline frame pacing, spin margin: %.3f milliseconds", (double)CORE.Time.Pacing.margin/1e6);
+#endif
+
     CORE.Time.previous = GetTime();     // Get time as double
 }
 
+#if defined(PLATFORM_DESKTOP)
+// Queue a timed input event
+// NOTE: When the queue is full, mouse moves replace the last event if it's a mouse move as well, other events are dropped
+static void AddTimedInputEvent(int type, int key, Vector2 position)
+{
+    TimedInputEvent event = { GetTime(), type, key, position };
+
+    if (CORE.Input.Timed.count < MAX_TIMED_INPUT_EVENTS) CORE.Input.Timed.events[CORE.Input.Timed.count++] = event;
+    else if ((type == TIMED_INPUT_MOUSE_MOVE) && (CORE.Input.Timed.events[MAX_TIMED_INPUT_EVENTS - 1].type == TIMED_INPUT_MOUSE_MOVE))
+    {
+        CORE.Input.Timed.events[MAX_TIMED_INPUT_EVENTS - 1] = event;
+    }
+}
+
+#if !defined(FRAME_PACING_DEADLINE) && !defined(SUPPORT_BUSY_WAIT_LOOP) && !defined(SUPPORT_CUSTOM_FRAME_CONTROL)
+// Wait for some time, processing input events as they arrive
+// NOTE: Same partial busy wait as WaitTime(), input events wake the wait up and it continues
+static void WaitTimeProcessingInput(double seconds)
+{
+    double destinationTime = GetTime() + seconds;
+#if defined(SUPPORT_PARTIALBUSY_WAIT_LOOP)
+    double sleepTime = destinationTime - seconds*0.05;
+#else
+    double sleepTime = destinationTime;
+#endif
+
+    for (double now = GetTime(); now < sleepTime; now = GetTime()) WaitInputEvents(sleepTime - now);
+
+#if defined(SUPPORT_PARTIALBUSY_WAIT_LOOP)
+    while (GetTime() < destinationTime) { }
+#endif
+}
+#endif
+#endif
+
+#if defined(FRAME_PACING_DEADLINE)
+// Get CLOCK_MONOTONIC time in nanoseconds
+static unsigned long long int GetMonotonicTime(void)
+{
+    struct timespec now = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (unsigned long long int)now.tv_sec*1000000000LLU + (unsigned long long int)now.tv_nsec;
+}
+
+// Sleep until an absolute CLOCK_MONOTONIC time
+// NOTE: Signals can't make it sleep too long or too short, the wake up time doesn't change
+static void SleepUntil(unsigned long long int time)
+{
+    struct timespec wakeUp = { 0 };
+    wakeUp.tv_sec = (time_t)(time/1000000000LLU);
+    wakeUp.tv_nsec = (long)(time%1000000000LLU);
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeUp, NULL) == EINTR) { }
+}
+
+// Adapt the spin margin to the oversleeping of a sleep
+static void UpdateFramePacingMargin(unsigned long long int oversleep)
+{
+    unsigned long long int margin = oversleep + oversleep/2;
+
+    // Oversleeping past the margin misses the deadline, so it grows at once and only shrinks slowly
+    if (margin > CORE.Time.Pacing.margin) CORE.Time.Pacing.margin = margin;
+    else CORE.Time.Pacing.margin -= (CORE.Time.Pacing.margin - margin)/64;
+
+    if (CORE.Time.Pacing.margin < FRAME_PACING_MIN_MARGIN) CORE.Time.Pacing.margin = FRAME_PACING_MIN_MARGIN;
+    if (CORE.Time.Pacing.margin > FRAME_PACING_MAX_MARGIN) CORE.Time.Pacing.margin = FRAME_PACING_MAX_MARGIN;
+}
+
+// Wait for the deadline of the next frame
+// NOTE: Deadlines are absolute, a frame that starts a bit late doesn't move the ones after it
+static void WaitFrameDeadline(void)
+{
+    unsigned long long int period = (unsigned long long int)(CORE.Time.target*1e9);
+    unsigned long long int now = GetMonotonicTime();
+
+    if ((CORE.Time.Pacing.period != period) || (CORE.Time.Pacing.deadline == 0))
+    {
+        CORE.Time.Pacing.period = period;
+        CORE.Time.Pacing.deadline = now;
+    }
+
+    CORE.Time.Pacing.deadline += period;
+
+    if (now >= CORE.Time.Pacing.deadline)
+    {
+        // Catching up with shorter frames would only stutter more, the deadlines start over
+        CORE.Time.Pacing.missed++;
+        CORE.Time.Pacing.deadline = CORE.Window.eventWaiting? 0 : now;
+        return;
+    }
+
+#if defined(PLATFORM_DESKTOP)
+    // Input is processed before and after the sleep instead of once after the wait, its events get their time within the frame
+    // NOTE: Waiting on input events would wake up as late as the event wait does, only the sleep itself adapts the margin
+    // NOTE: When waiting for events they are left to PollInputEvents(), processing them here wouldn't end its wait
+    if (!CORE.Window.eventWaiting) ProcessInputEvents();
+    now = GetMonotonicTime();
+#endif
+
+    unsigned long long int wakeUp = CORE.Time.Pacing.deadline - CORE.Time.Pacing.margin;
+    if (wakeUp > now)
+    {
+        SleepUntil(wakeUp);
+        now = GetMonotonicTime();
+        UpdateFramePacingMargin((now > wakeUp)? now - wakeUp : 0);
+    }
+
+#if defined(PLATFORM_DESKTOP)
+    if (!CORE.Window.eventWaiting) ProcessInputEvents();
+    now = GetMonotonicTime();
+#endif
+
+    unsigned long long int spinStart = now;
+    while (now < CORE.Time.Pacing.deadline) now = GetMonotonicTime();
+
+    unsigned int index = CORE.Time.Pacing.index;
+    CORE.Time.Pacing.lateness[index] = (unsigned int)(now - CORE.Time.Pacing.deadline);
+    CORE.Time.Pacing.spin[index] = (unsigned int)(now - spinStart);
+    CORE.Time.Pacing.index = (index + 1)%FRAME_PACING_STATS_FRAMES;
+    if (CORE.Time.Pacing.count < FRAME_PACING_STATS_FRAMES) CORE.Time.Pacing.count++;
+
+    // Waiting for events delays the next frame on purpose, it isn't a missed deadline
+    if (CORE.Window.eventWaiting) CORE.Time.Pacing.deadline = 0;
+}
+#endif
+
 // Set viewport for a provided width and height
 void SetupViewport(int width, int height)
 {
@@ -3264,267 +3847,423 @@ static void ScanDirectoryFilesRecursively(const char *basePath, FilePathList *fi
 }
 
 #if defined(SUPPORT_AUTOMATION_EVENTS)
-// Automation event recording
-// NOTE: Recording is by default done at EndDrawing(), after PollInputEvents()
-static void RecordAutomationEvent(void)
+// Grow events list capacity to hold count events, doubling it to keep recording amortized O(1)
+static bool ReserveAutomationEvents(AutomationEventList *list, unsigned int count)
 {
-    // Checking events in current frame and save them into currentEventList
-    // TODO: How important is the current frame? Could it be modified?
+    if (count <= list->capacity) return true;
 
-    if (currentEventList->count == currentEventList->capacity) return;    // Security check
+    unsigned int capacity = (list->capacity > 0)? list->capacity : AUTOMATION_EVENTS_CAPACITY;
+    while (capacity < count) capacity *= 2;
 
-    // Keyboard input events recording
-    //-------------------------------------------------------------------------------------
-    for (int key = 0; key < MAX_KEYBOARD_KEYS; key++)
+    AutomationEvent *events = (AutomationEvent *)RL_REALLOC(list->events, capacity*sizeof(AutomationEvent));
+    if (events == NULL)
     {
-        // Event type: INPUT_KEY_UP (only saved once)
-        if (CORE.Input.Keyboard.previousKeyState[key] && !CORE.Input.Keyboard.currentKeyState[key])
-        {
-            currentEventList->events[currentEventList->count].frame = CORE.Time.frameCounter;
-            currentEventList->events[currentEventList->count].type = INPUT_KEY_UP;
-            currentEventList->events[currentEventList->count].params[0] = key;
-            currentEventList->events[currentEventList->count].params[1] = 0;
-            currentEventList->events[currentEventList->count].params[2] = 0;
-
-            TRACELOG(LOG_INFO, "AUTOMATION: Frame: %i | Event type: INPUT_KEY_UP | Event parameters: %i, %i, %i", currentEventList->events[currentEventList->count].frame, currentEventList->events[currentEventList->count].params[0], currentEventList->events[currentEventList->count].params[1], currentEventList->events[currentEventList->count].params[2]);
-            currentEventList->count++;
-        }
+        TRACELOG(LOG_WARNING, "AUTOMATION: Failed to grow events list to %i events", capacity);
+        return false;
+    }
 
-        if (currentEventList->count == currentEventList->capacity) return;    // Security check
+    list->events = events;
+    list->capacity = capacity;
+    return true;
+}
 
-        // Event type: INPUT_KEY_DOWN
-        if (CORE.Input.Keyboard.currentKeyState[key])
-        {
-            currentEventList->events[currentEventList->count].frame = CORE.Time.frameCounter;
-            currentEventList->events[currentEventList->count].type = INPUT_KEY_DOWN;
-            currentEventList->events[currentEventList->count].params[0] = key;
-            currentEventList->events[currentEventList->count].params[1] = 0;
-            currentEventList->events[currentEventList->count].params[2] = 0;
-
-            TRACELOG(LOG_INFO, "AUTOMATION: Frame: %i | Event type: INPUT_KEY_DOWN | Event parameters: %i, %i, %i", currentEventList->events[currentEventList->count].frame, currentEventList->events[currentEventList->count].params[0], currentEventList->events[currentEventList->count].params[1], currentEventList->events[currentEventList->count].params[2]);
-            currentEventList->count++;
-        }
+static void WriteAutomationU32(unsigned char *data, unsigned int value)
+{
+    data[0] = (unsigned char)value;
+    data[1] = (unsigned char)(value >> 8);
+    data[2] = (unsigned char)(value >> 16);
+    data[3] = (unsigned char)(value >> 24);
+}
+
+static unsigned int ReadAutomationU32(const unsigned char *data)
+{
+    return (unsigned int)data[0] | ((unsigned int)data[1] << 8) | ((unsigned int)data[2] << 16) | ((unsigned int)data[3] << 24);
+}
 
-        if (currentEventList->count == currentEventList->capacity) return;    // Security check
+// Write a signed value as zigzag varint, small magnitudes take one byte
+static unsigned int WriteAutomationVarint(unsigned char *data, int value)
+{
+    unsigned int zigzag = ((unsigned int)value << 1) ^ (unsigned int)(value >> 31);
+    unsigned int size = 0;
+
+    while (zigzag >= 0x80)
+    {
+        data[size++] = (unsigned char)(zigzag | 0x80);
+        zigzag >>= 7;
     }
-    //-------------------------------------------------------------------------------------
 
-    // Mouse input currentEventList->events recording
-    //-------------------------------------------------------------------------------------
-    for (int button = 0; button < MAX_MOUSE_BUTTONS; button++)
+    data[size++] = (unsigned char)zigzag;
+    return size;
+}
+
+// Read a zigzag varint, false if it runs past the end of data
+static bool ReadAutomationVarint(const unsigned char *data, unsigned int size, unsigned int *offset, int *value)
+{
+    unsigned int zigzag = 0;
+
+    for (unsigned int shift = 0; (shift < 35) && (*offset < size); shift += 7)
     {
-        // Event type: INPUT_MOUSE_BUTTON_UP
-        if (CORE.Input.Mouse.previousButtonState[button] && !CORE.Input.Mouse.currentButtonState[button])
+        unsigned char byte = data[(*offset)++];
+        zigzag |= (unsigned int)(byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0)
         {
-            currentEventList->events[currentEventList->count].frame = CORE.Time.frameCounter;
-            currentEventList->events[currentEventList->count].type = INPUT_MOUSE_BUTTON_UP;
-            currentEventList->events[currentEventList->count].params[0] = button;
-            currentEventList->events[currentEventList->count].params[1] = 0;
-            currentEventList->events[currentEventList->count].params[2] = 0;
-
-            TRACELOG(LOG_INFO, "AUTOMATION: Frame: %i | Event type: INPUT_MOUSE_BUTTON_UP | Event parameters: %i, %i, %i", currentEventList->events[currentEventList->count].frame, currentEventList->events[currentEventList->count].params[0], currentEventList->events[currentEventList->count].params[1], currentEventList->events[currentEventList->count].params[2]);
-            currentEventList->count++;
+            *value = (int)(zigzag >> 1) ^ -(int)(zigzag & 1);
+            return true;
         }
+    }
 
-        if (currentEventList->count == currentEventList->capacity) return;    // Security check
+    return false;
+}
 
-        // Event type: INPUT_MOUSE_BUTTON_DOWN
-        if (CORE.Input.Mouse.currentButtonState[button])
-        {
-            currentEventList->events[currentEventList->count].frame = CORE.Time.frameCounter;
-            currentEventList->events[currentEventList->count].type = INPUT_MOUSE_BUTTON_DOWN;
-            currentEventList->events[currentEventList->count].params[0] = button;
-            currentEventList->events[currentEventList->count].params[1] = 0;
-            currentEventList->events[currentEventList->count].params[2] = 0;
-
-            TRACELOG(LOG_INFO, "AUTOMATION: Frame: %i | Event type: INPUT_MOUSE_BUTTON_DOWN | Event parameters: %i, %i, %i", currentEventList->events[currentEventList->count].frame, currentEventList->events[currentEventList->count].params[0], currentEventList->events[currentEventList->count].params[1], currentEventList->events[currentEventList->count].params[2]);
-            currentEventList->count++;
-        }
+// Encode events into one chunk of a binary automation events file
+static AutomationChunk *EncodeAutomationChunk(const AutomationEvent *events, unsigned int count)
+{
+    AutomationChunk *chunk = (AutomationChunk *)RL_MALLOC(sizeof(AutomationChunk) + AUTOMATION_CHUNK_HEADER + count*AUTOMATION_EVENT_MAX_SIZE);
+    if (chunk == NULL) return NULL;
 
-        if (currentEventList->count == currentEventList->capacity) return;    // Security check
-    }
+    unsigned int size = AUTOMATION_CHUNK_HEADER;
+    unsigned int frame = 0;
 
-    // Event type: INPUT_MOUSE_POSITION (only saved if changed)
-    if (((int)CORE.Input.Mouse.currentPosition.x != (int)CORE.Input.Mouse.previousPosition.x) ||
-        ((int)CORE.Input.Mouse.currentPosition.y != (int)CORE.Input.Mouse.previousPosition.y))
+    for (unsigned int i = 0; i < count; i++)
     {
-        currentEventList->events[currentEventList->count].frame = CORE.Time.frameCounter;
-        currentEventList->events[currentEventList->count].type = INPUT_MOUSE_POSITION;
-        currentEventList->events[currentEventList->count].params[0] = (int)CORE.Input.Mouse.currentPosition.x;
-        currentEventList->events[currentEventList->count].params[1] = (int)CORE.Input.Mouse.currentPosition.y;
-        currentEventList->events[currentEventList->count].params[2] = 0;
+        size += WriteAutomationVarint(chunk->data + size, (int)(events[i].frame - frame));
+        size += WriteAutomationVarint(chunk->data + size, (int)events[i].type);
+        for (int p = 0; p < 4; p++) size += WriteAutomationVarint(chunk->data + size, events[i].params[p]);
+        frame = events[i].frame;
+    }
 
-        TRACELOG(LOG_INFO, "AUTOMATION: Frame: %i | Event type: INPUT_MOUSE_POSITION | Event parameters: %i, %i, %i", currentEventList->events[currentEventList->count].frame, currentEventList->events[currentEventList->count].params[0], currentEventList->events[currentEventList->count].params[1], currentEventList->events[currentEventList->count].params[2]);
-        currentEventList->count++;
+    WriteAutomationU32(chunk->data, count);
+    WriteAutomationU32(chunk->data + 4, size - AUTOMATION_CHUNK_HEADER);
+    chunk->next = NULL;
+    chunk->size = size;
+    return chunk;
+}
 
-        if (currentEventList->count == currentEventList->capacity) return;    // Security check
-    }
+// Decode a binary automation events file into list, false if it ends in an incomplete chunk
+static bool DecodeAutomationEvents(const unsigned char *data, unsigned int dataSize, AutomationEventList *list)
+{
+    if (ReadAutomationU32(data + 4) != AUTOMATION_FILE_VERSION) return false;
 
-    // Event type: INPUT_MOUSE_WHEEL_MOTION
-    if (((int)CORE.Input.Mouse.currentWheelMove.x != (int)CORE.Input.Mouse.previousWheelMove.x) ||
-        ((int)CORE.Input.Mouse.currentWheelMove.y != (int)CORE.Input.Mouse.previousWheelMove.y))
+    unsigned int offset = 8;
+    while (offset < dataSize)
     {
-        currentEventList->events[currentEventList->count].frame = CORE.Time.frameCounter;
-        currentEventList->events[currentEventList->count].type = INPUT_MOUSE_WHEEL_MOTION;
-        currentEventList->events[currentEventList->count].params[0] = (int)CORE.Input.Mouse.currentWheelMove.x;
-        currentEventList->events[currentEventList->count].params[1] = (int)CORE.Input.Mouse.currentWheelMove.y;;
-        currentEventList->events[currentEventList->count].params[2] = 0;
+        if ((dataSize - offset) < AUTOMATION_CHUNK_HEADER) return false;
+
+        unsigned int count = ReadAutomationU32(data + offset);
+        unsigned int size = ReadAutomationU32(data + offset + 4);
+        offset += AUTOMATION_CHUNK_HEADER;
+
+        // NOTE: Every event takes at least 6 bytes, a corrupted count can't allocate more than the file justifies
+        if ((size > (dataSize - offset)) || (count > size/6) || !ReserveAutomationEvents(list, list->count + count)) return false;
+
+        // Decode into the free capacity first, a corrupted chunk doesn't end up half in the list
+        const unsigned int end = offset + size;
+        AutomationEvent *events = list->events + list->count;
+        unsigned int frame = 0;
+        bool valid = true;
 
-        TRACELOG(LOG_INFO, "AUTOMATION: Frame: %i | Event type: INPUT_MOUSE_WHEEL_MOTION | Event parameters: %i, %i, %i", currentEventList->events[currentEventList->count].frame, currentEventList->events[currentEventList->count].params[0], currentEventList->events[currentEventList->count].params[1], currentEventList->events[currentEventList->count].params[2]);
-        currentEventList->count++;
+        for (unsigned int i = 0; valid && (i < count); i++) valid = DecodeAutomationEvent(data, end, &offset, &frame, &events[i]);
 
-        if (currentEventList->count == currentEventList->capacity) return;    // Security check
+        if (!valid || (offset != end)) return false;
+        list->count += count;
     }
-    //-------------------------------------------------------------------------------------
 
-    // Touch input currentEventList->events recording
-    //-------------------------------------------------------------------------------------
-    for (int id = 0; id < MAX_TOUCH_POINTS; id++)
+    return true;
+}
+
+// Decode one event of a chunk, frame is the one of the previous event of the chunk (0 for the first)
+static bool DecodeAutomationEvent(const unsigned char *data, unsigned int end, unsigned int *offset, unsigned int *frame, AutomationEvent *event)
+{
+    int delta = 0;
+    int type = 0;
+    bool valid = ReadAutomationVarint(data, end, offset, &delta) && ReadAutomationVarint(data, end, offset, &type);
+    for (int p = 0; p < 4; p++) valid = valid && ReadAutomationVarint(data, end, offset, &event->params[p]);
+
+    *frame += (unsigned int)delta;
+    event->frame = *frame;
+    event->type = (unsigned int)type;
+    return valid;
+}
+
+// Map a file into memory read only, falls back to LoadFileData() where mapping is not supported
+static unsigned char *MapFileData(const char *fileName, unsigned int *dataSize)
+{
+    unsigned char *data = NULL;
+    *dataSize = 0;
+
+#if defined(_WIN32)
+    void *file = CreateFileA(fileName, 0x80000000 /* GENERIC_READ */, 1 /* FILE_SHARE_READ */, NULL, 3 /* OPEN_EXISTING */, 0x80 /* FILE_ATTRIBUTE_NORMAL */, NULL);
+    if (file == (void *)-1) return NULL;
+
+    long long size = 0;
+    if (GetFileSizeEx(file, &size) && (size > 0) && (size < 0x7FFFFFFF))
     {
-        // Event type: INPUT_TOUCH_UP
-        if (CORE.Input.Touch.previousTouchState[id] && !CORE.Input.Touch.currentTouchState[id])
+        // NOTE: The view keeps the mapping and the file open, both handles can be closed right away
+        void *mapping = CreateFileMappingA(file, NULL, 2 /* PAGE_READONLY */, 0, 0, NULL);
+        if (mapping != NULL)
         {
-            currentEventList->events[currentEventList->count].frame = CORE.Time.frameCounter;
-            currentEventList->events[currentEventList->count].type = INPUT_TOUCH_UP;
-            currentEventList->events[currentEventList->count].params[0] = id;
-            currentEventList->events[currentEventList->count].params[1] = 0;
-            currentEventList->events[currentEventList->count].params[2] = 0;
-
-            TRACELOG(LOG_INFO, "AUTOMATION: Frame: %i | Event type: INPUT_TOUCH_UP | Event parameters: %i, %i, %i", currentEventList->events[currentEventList->count].frame, currentEventList->events[currentEventList->count].params[0], currentEventList->events[currentEventList->count].params[1], currentEventList->events[currentEventList->count].params[2]);
-            currentEventList->count++;
+            data = (unsigned char *)MapViewOfFile(mapping, 4 /* FILE_MAP_READ */, 0, 0, 0);
+            CloseHandle(mapping);
         }
+        if (data != NULL) *dataSize = (unsigned int)size;
+    }
 
-        if (currentEventList->count == currentEventList->capacity) return;    // Security check
+    CloseHandle(file);
+#elif defined(AUTOMATION_MAP_FILE)
+    int file = open(fileName, O_RDONLY);
+    if (file < 0) return NULL;
 
-        // Event type: INPUT_TOUCH_DOWN
-        if (CORE.Input.Touch.currentTouchState[id])
+    struct stat info;
+    if ((fstat(file, &info) == 0) && (info.st_size > 0) && (info.st_size < 0x7FFFFFFF))
+    {
+        void *mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (mapping != MAP_FAILED)
         {
-            currentEventList->events[currentEventList->count].frame = CORE.Time.frameCounter;
-            currentEventList->events[currentEventList->count].type = INPUT_TOUCH_DOWN;
-            currentEventList->events[currentEventList->count].params[0] = id;
-            currentEventList->events[currentEventList->count].params[1] = 0;
-            currentEventList->events[currentEventList->count].params[2] = 0;
-
-            TRACELOG(LOG_INFO, "AUTOMATION: Frame: %i | Event type: INPUT_TOUCH_DOWN | Event parameters: %i, %i, %i", currentEventList->events[currentEventList->count].frame, currentEventList->events[currentEventList->count].params[0], currentEventList->events[currentEventList->count].params[1], currentEventList->events[currentEventList->count].params[2]);
-            currentEventList->count++;
+            data = (unsigned char *)mapping;
+            *dataSize = (unsigned int)info.st_size;
         }
+    }
 
-        if (currentEventList->count == currentEventList->capacity) return;    // Security check
+    close(file);
+#else
+    int size = 0;
+    data = LoadFileData(fileName, &size);
+    *dataSize = (unsigned int)size;
+#endif
 
-        // Event type: INPUT_TOUCH_POSITION
-        // TODO: It requires the id!
-        /*
-        if (((int)CORE.Input.Touch.currentPosition[id].x != (int)CORE.Input.Touch.previousPosition[id].x) ||
-            ((int)CORE.Input.Touch.currentPosition[id].y != (int)CORE.Input.Touch.previousPosition[id].y))
+    return data;
+}
+
+// Unmap file data mapped with MapFileData()
+static void UnmapFileData(unsigned char *data, unsigned int dataSize)
+{
+#if defined(_WIN32)
+    UnmapViewOfFile(data);
+#elif defined(AUTOMATION_MAP_FILE)
+    munmap(data, dataSize);
+#else
+    UnloadFileData(data);
+#endif
+}
+
+// Write queued chunks to the stream file and free them
+static void WriteAutomationChunks(AutomationChunk *chunk)
+{
+    while (chunk != NULL)
+    {
+        AutomationChunk *next = chunk->next;
+        if (fwrite(chunk->data, 1, chunk->size, automationStream.file) != chunk->size) TRACELOG(LOG_WARNING, "AUTOMATION: Failed to write events to stream");
+        RL_FREE(chunk);
+        chunk = next;
+    }
+
+    fflush(automationStream.file);
+}
+
+#if defined(AUTOMATION_STREAM_THREAD)
+// Stream writer thread, keeps the file IO off the recording thread
+#if defined(_WIN32)
+static unsigned long __stdcall AutomationStreamThread(void *param)
+#else
+static void *AutomationStreamThread(void *param)
+#endif
+{
+    (void)param;
+
+    for (;;)
+    {
+        AUTOMATION_STREAM_LOCK();
+        while ((automationStream.first == NULL) && !automationStream.quit) AUTOMATION_STREAM_WAIT();
+        AutomationChunk *chunks = automationStream.first;
+        automationStream.first = NULL;
+        automationStream.last = NULL;
+        AUTOMATION_STREAM_UNLOCK();
+
+        if (chunks == NULL) break;      // Quit with nothing left to write
+        WriteAutomationChunks(chunks);
+    }
+
+    return 0;
+}
+#endif
+
+// Hand recorded events to the stream writer, in full chunks unless flushing
+// NOTE: Streamed events are removed from the list, recording memory doesn't grow with the session length
+static void StreamAutomationEvents(bool flush)
+{
+    // NOTE: The list could have been unset by the user since the last frame
+    if (currentEventList == NULL) return;
+
+    unsigned int encoded = 0;
+    while ((currentEventList->count - encoded) >= (flush? 1 : AUTOMATION_CHUNK_EVENTS))
+    {
+        unsigned int count = currentEventList->count - encoded;
+        if (count > AUTOMATION_CHUNK_EVENTS) count = AUTOMATION_CHUNK_EVENTS;
+
+        AutomationChunk *chunk = EncodeAutomationChunk(currentEventList->events + encoded, count);
+        if (chunk == NULL) break;       // Retried on the next frame
+        encoded += count;
+        automationStream.streamed += count;
+
+        // NOTE: quit is only set from this thread, without a writer thread it is set from the start
+        if (automationStream.quit) WriteAutomationChunks(chunk);
+#if defined(AUTOMATION_STREAM_THREAD)
+        else
         {
-            currentEventList->events[currentEventList->count].frame = CORE.Time.frameCounter;
-            currentEventList->events[currentEventList->count].type = INPUT_TOUCH_POSITION;
-            currentEventList->events[currentEventList->count].params[0] = id;
-            currentEventList->events[currentEventList->count].params[1] = (int)CORE.Input.Touch.currentPosition[id].x;
-            currentEventList->events[currentEventList->count].params[2] = (int)CORE.Input.Touch.currentPosition[id].y;
-
-            TRACELOG(LOG_INFO, "AUTOMATION: Frame: %i | Event type: INPUT_TOUCH_POSITION | Event parameters: %i, %i, %i", currentEventList->events[currentEventList->count].frame, currentEventList->events[currentEventList->count].params[0], currentEventList->events[currentEventList->count].params[1], currentEventList->events[currentEventList->count].params[2]);
-            currentEventList->count++;
+            AUTOMATION_STREAM_LOCK();
+            if (automationStream.last != NULL) automationStream.last->next = chunk;
+            else automationStream.first = chunk;
+            automationStream.last = chunk;
+            AUTOMATION_STREAM_WAKE();
+            AUTOMATION_STREAM_UNLOCK();
         }
-        */
+#endif
+    }
 
-        if (currentEventList->count == currentEventList->capacity) return;    // Security check
+    if (encoded > 0)
+    {
+        currentEventList->count -= encoded;
+        memmove(currentEventList->events, currentEventList->events + encoded, currentEventList->count*sizeof(AutomationEvent));
     }
-    //-------------------------------------------------------------------------------------
+}
 
-    // Gamepad input currentEventList->events recording
-    //-------------------------------------------------------------------------------------
+#if !defined(SUPPORT_CUSTOM_FRAME_CONTROL)
+// Put the state of played gamepad events back over the polled one, called after PollInputEvents() in EndDrawing()
+// NOTE: Gamepad events are recorded on change only, but polling rewrites the gamepad state every frame
+// NOTE: Only held buttons and moved axes are kept, the state of the real gamepad still gets through otherwise
+static void KeepAutomationGamepadState(void)
+{
     for (int gamepad = 0; gamepad < MAX_GAMEPADS; gamepad++)
     {
-        // Event type: INPUT_GAMEPAD_CONNECT
-        /*
-        if ((CORE.Input.Gamepad.currentState[gamepad] != CORE.Input.Gamepad.previousState[gamepad]) &&
-            (CORE.Input.Gamepad.currentState[gamepad])) // Check if changed to ready
+        for (int button = 0; button < MAX_GAMEPAD_BUTTONS; button++)
         {
-            // TODO: Save gamepad connect event
+            if (automationButtonsPlayed[gamepad][button]) CORE.Input.Gamepad.currentButtonState[gamepad][button] = 1;
         }
-        */
 
-        // Event type: INPUT_GAMEPAD_DISCONNECT
-        /*
-        if ((CORE.Input.Gamepad.currentState[gamepad] != CORE.Input.Gamepad.previousState[gamepad]) &&
-            (!CORE.Input.Gamepad.currentState[gamepad])) // Check if changed to not-ready
+        for (int axis = 0; axis < MAX_GAMEPAD_AXIS; axis++)
         {
-            // TODO: Save gamepad disconnect event
+            if (automationAxisPlayed[gamepad][axis] != 0) CORE.Input.Gamepad.axisState[gamepad][axis] = ((float)automationAxisPlayed[gamepad][axis]/32768.0f);
         }
-        */
-
-        for (int button = 0; button < MAX_GAMEPAD_BUTTONS; button++)
-        {
-            // Event type: INPUT_GAMEPAD_BUTTON_UP
-            if (CORE.Input.Gamepad.previousButtonState[gamepad][button] && !CORE.Input.Gamepad.currentButtonState[gamepad][button])
-            {
-                currentEventList->events[currentEventList->count].frame = CORE.Time.frameCounter;
-                currentEventList->events[currentEventList->count].type = INPUT_GAMEPAD_BUTTON_UP;
-                currentEventList->events[currentEventList->count].params[0] = gamepad;
-                currentEventList->events[currentEventList->count].params[1] = button;
-                currentEventList->events[currentEventList->count].params[2] = 0;
-
-                TRACELOG(LOG_INFO, "AUTOMATION: Frame: %i | Event type: INPUT_GAMEPAD_BUTTON_UP | Event parameters: %i, %i, %i", currentEventList->events[currentEventList->count].frame, currentEventList->events[currentEventList->count].params[0], currentEventList->events[currentEventList->count].params[1], currentEventList->events[currentEventList->count].params[2]);
-                currentEventList->count++;
-            }
+    }
+}
+#endif
 
-            if (currentEventList->count == currentEventList->capacity) return;    // Security check
+// Add an event of the current frame to the recorded list
+static void AddAutomationEvent(unsigned int type, int param0, int param1, int param2)
+{
+    if (!ReserveAutomationEvents(currentEventList, currentEventList->count + 1)) return;    // Out of memory
 
-            // Event type: INPUT_GAMEPAD_BUTTON_DOWN
-            if (CORE.Input.Gamepad.currentButtonState[gamepad][button])
-            {
-                currentEventList->events[currentEventList->count].frame = CORE.Time.frameCounter;
-                currentEventList->events[currentEventList->count].type = INPUT_GAMEPAD_BUTTON_DOWN;
-                currentEventList->events[currentEventList->count].params[0] = gamepad;
-                currentEventList->events[currentEventList->count].params[1] = button;
-                currentEventList->events[currentEventList->count].params[2] = 0;
-
-                TRACELOG(LOG_INFO, "AUTOMATION: Frame: %i | Event type: INPUT_GAMEPAD_BUTTON_DOWN | Event parameters: %i, %i, %i", currentEventList->events[currentEventList->count].frame, currentEventList->events[currentEventList->count].params[0], currentEventList->events[currentEventList->count].params[1], currentEventList->events[currentEventList->count].params[2]);
-                currentEventList->count++;
-            }
+    AutomationEvent *event = &currentEventList->events[currentEventList->count];
+    event->frame = CORE.Time.frameCounter;
+    event->type = type;
+    event->params[0] = param0;
+    event->params[1] = param1;
+    event->params[2] = param2;
+    event->params[3] = 0;
+    currentEventList->count++;
+    automationEventsRecorded++;
+}
 
-            if (currentEventList->count == currentEventList->capacity) return;    // Security check
+// Record an up or down event for every state that changed since the previous frame
+// NOTE: States are compared 8 at a time, a frame without changes costs a few compares instead of a check per key
+static void RecordAutomationStateChanges(const char *previous, const char *current, int count, unsigned int upType, unsigned int downType, int gamepad)
+{
+    for (int i = 0; i < count; i += 8)
+    {
+        if ((i + 8) <= count)
+        {
+            unsigned long long previousWord = 0;
+            unsigned long long currentWord = 0;
+            memcpy(&previousWord, previous + i, 8);
+            memcpy(&currentWord, current + i, 8);
+            if (previousWord == currentWord) continue;
         }
 
-        for (int axis = 0; axis < MAX_GAMEPAD_AXIS; axis++)
+        for (int j = i; (j < (i + 8)) && (j < count); j++)
         {
-            // Event type: INPUT_GAMEPAD_AXIS_MOTION
-            if (CORE.Input.Gamepad.axisState[gamepad][axis] > 0.1f)
-            {
-                currentEventList->events[currentEventList->count].frame = CORE.Time.frameCounter;
-                currentEventList->events[currentEventList->count].type = INPUT_GAMEPAD_AXIS_MOTION;
-                currentEventList->events[currentEventList->count].params[0] = gamepad;
-                currentEventList->events[currentEventList->count].params[1] = axis;
-                currentEventList->events[currentEventList->count].params[2] = (int)(CORE.Input.Gamepad.axisState[gamepad][axis]*32768.0f);
-
-                TRACELOG(LOG_INFO, "AUTOMATION: Frame: %i | Event type: INPUT_GAMEPAD_AXIS_MOTION | Event parameters: %i, %i, %i", currentEventList->events[currentEventList->count].frame, currentEventList->events[currentEventList->count].params[0], currentEventList->events[currentEventList->count].params[1], currentEventList->events[currentEventList->count].params[2]);
-                currentEventList->count++;
-            }
+            if (previous[j] == current[j]) continue;
 
-            if (currentEventList->count == currentEventList->capacity) return;    // Security check
+            // Gamepad events take the gamepad as first parameter
+            if (gamepad < 0) AddAutomationEvent(current[j]? downType : upType, j, 0, 0);
+            else AddAutomationEvent(current[j]? downType : upType, gamepad, j, 0);
         }
     }
+}
+
+// Automation event recording
+// NOTE: Recording is by default done at EndDrawing(), after PollInputEvents()
+// Only changes are recorded (a held key is one INPUT_KEY_DOWN event), playback keeps the state until the matching up event
+static void RecordAutomationEvent(void)
+{
+    // Checking events in current frame and save them into currentEventList
+    // NOTE: Nothing is logged per event, StopAutomationEventRecording() logs the total
+
+    // Keyboard input events recording
+    //-------------------------------------------------------------------------------------
+    // Event type: INPUT_KEY_UP, INPUT_KEY_DOWN
+    RecordAutomationStateChanges(CORE.Input.Keyboard.previousKeyState, CORE.Input.Keyboard.currentKeyState, MAX_KEYBOARD_KEYS, INPUT_KEY_UP, INPUT_KEY_DOWN, -1);
     //-------------------------------------------------------------------------------------
 
-    // Gestures input currentEventList->events recording
+    // Mouse input currentEventList->events recording
+    //-------------------------------------------------------------------------------------
+    // Event type: INPUT_MOUSE_BUTTON_UP, INPUT_MOUSE_BUTTON_DOWN
+    RecordAutomationStateChanges(CORE.Input.Mouse.previousButtonState, CORE.Input.Mouse.currentButtonState, MAX_MOUSE_BUTTONS, INPUT_MOUSE_BUTTON_UP, INPUT_MOUSE_BUTTON_DOWN, -1);
+
+    // Event type: INPUT_MOUSE_POSITION (only saved if changed)
+    if (((int)CORE.Input.Mouse.currentPosition.x != (int)CORE.Input.Mouse.previousPosition.x) ||
+        ((int)CORE.Input.Mouse.currentPosition.y != (int)CORE.Input.Mouse.previousPosition.y))
+    {
+        AddAutomationEvent(INPUT_MOUSE_POSITION, (int)CORE.Input.Mouse.currentPosition.x, (int)CORE.Input.Mouse.currentPosition.y, 0);
+    }
+
+    // Event type: INPUT_MOUSE_WHEEL_MOTION
+    if (((int)CORE.Input.Mouse.currentWheelMove.x != (int)CORE.Input.Mouse.previousWheelMove.x) ||
+        ((int)CORE.Input.Mouse.currentWheelMove.y != (int)CORE.Input.Mouse.previousWheelMove.y))
+    {
+        AddAutomationEvent(INPUT_MOUSE_WHEEL_MOTION, (int)CORE.Input.Mouse.currentWheelMove.x, (int)CORE.Input.Mouse.currentWheelMove.y, 0);
+    }
     //-------------------------------------------------------------------------------------
-    if (GESTURES.current != GESTURE_NONE)
+
+    // Touch input currentEventList->events recording
+    //-------------------------------------------------------------------------------------
+    // Event type: INPUT_TOUCH_UP, INPUT_TOUCH_DOWN
+    RecordAutomationStateChanges(CORE.Input.Touch.previousTouchState, CORE.Input.Touch.currentTouchState, MAX_TOUCH_POINTS, INPUT_TOUCH_UP, INPUT_TOUCH_DOWN, -1);
+
+    // Event type: INPUT_TOUCH_POSITION
+    // TODO: It requires the id!
+    //-------------------------------------------------------------------------------------
+
+    // Gamepad input currentEventList->events recording
+    //-------------------------------------------------------------------------------------
+    for (int gamepad = 0; gamepad < MAX_GAMEPADS; gamepad++)
     {
-        // Event type: INPUT_GESTURE
-        currentEventList->events[currentEventList->count].frame = CORE.Time.frameCounter;
-        currentEventList->events[currentEventList->count].type = INPUT_GESTURE;
-        currentEventList->events[currentEventList->count].params[0] = GESTURES.current;
-        currentEventList->events[currentEventList->count].params[1] = 0;
-        currentEventList->events[currentEventList->count].params[2] = 0;
+        // Event type: INPUT_GAMEPAD_CONNECT, INPUT_GAMEPAD_DISCONNECT
+        // TODO: Save gamepad connect and disconnect events
 
-        TRACELOG(LOG_INFO, "AUTOMATION: Frame: %i | Event type: INPUT_GESTURE | Event parameters: %i, %i, %i", currentEventList->events[currentEventList->count].frame, currentEventList->events[currentEventList->count].params[0], currentEventList->events[currentEventList->count].params[1], currentEventList->events[currentEventList->count].params[2]);
-        currentEventList->count++;
+        // Event type: INPUT_GAMEPAD_BUTTON_UP, INPUT_GAMEPAD_BUTTON_DOWN
+        RecordAutomationStateChanges(CORE.Input.Gamepad.previousButtonState[gamepad], CORE.Input.Gamepad.currentButtonState[gamepad], MAX_GAMEPAD_BUTTONS, INPUT_GAMEPAD_BUTTON_UP, INPUT_GAMEPAD_BUTTON_DOWN, gamepad);
 
-        if (currentEventList->count == currentEventList->capacity) return;    // Security check
+        for (int axis = 0; axis < MAX_GAMEPAD_AXIS; axis++)
+        {
+            // Event type: INPUT_GAMEPAD_AXIS_MOTION (only saved if moved by more than 1%, sticks are never perfectly still)
+            int value = (int)(CORE.Input.Gamepad.axisState[gamepad][axis]*32768.0f);
+            int moved = value - automationAxisState[gamepad][axis];
+            if ((moved > 327) || (moved < -327) || ((value == 0) && (moved != 0)))
+            {
+                AddAutomationEvent(INPUT_GAMEPAD_AXIS_MOTION, gamepad, axis, value);
+                automationAxisState[gamepad][axis] = value;
+            }
+        }
     }
     //-------------------------------------------------------------------------------------
 
+    // Gestures input currentEventList->events recording
+    //-------------------------------------------------------------------------------------
+    // Event type: INPUT_GESTURE
+    if (GESTURES.current != GESTURE_NONE) AddAutomationEvent(INPUT_GESTURE, GESTURES.current, 0, 0);
+    //-------------------------------------------------------------------------------------
+
     // Window events recording
     //-------------------------------------------------------------------------------------
     // TODO.
@@ -46,6 +46,18 @@
 *       #define RLGL_ENABLE_OPENGL_DEBUG_CONTEXT
 *           Enable debug context (only available on OpenGL 4.3)
 *
+*       #define RLGL_BATCH_ORPHAN_BUFFERS
+*           Orphan the storage of the internal render batch buffers before uploading into them (OpenGL 3.3+ and ES2),
+*           the driver hands out fresh memory instead of waiting for draws that still read the previous data
+*           Together with RL_DEFAULT_BATCH_BUFFERS > 1 a batch upload never waits on the previous frame's draws
+*
+*       #define RLGL_BATCH_VERTEX_2D
+*           Store 2D vertex in the internal render batches (OpenGL 3.3+ and ES2): XY positions and
+*           16 bit normalized texcoords instead of XYZ and float texcoords, 12 bytes less per vertex to write and upload
+*           Z is dropped (3D shapes drawn through the batch are flattened) and texcoords are clamped to [0..1],
+*           the default shader has a variant for it, custom shaders declaring vec3 vertexPosition get Z = 0
+*           It must be defined the same for every file including rlgl.h that accesses the batch buffers
+*
 *       rlgl capabilities could be customized just defining some internal
 *       values before library inclusion (default values listed):
 *
@@ -340,12 +352,23 @@ typedef struct Matrix {
 #define RL_MATRIX_TYPE
 #endif
 
+#if defined(RLGL_BATCH_VERTEX_2D)
+    #define RL_BATCH_POSITION_COMPONENTS    2   // Position components per render batch vertex (XY)
+#else
+    #define RL_BATCH_POSITION_COMPONENTS    3   // Position components per render batch vertex (XYZ)
+#endif
+
 // Dynamic vertex buffers (position + texcoords + colors + indices arrays)
 typedef struct rlVertexBuffer {
     int elementCount;           // Number of elements in the buffer (QUADS)
 
+#if defined(RLGL_BATCH_VERTEX_2D)
+    float *vertices;            // Vertex position (XY - 2 components per vertex) (shader-location = 0)
+    unsigned short *texcoords;  // Vertex texture coordinates (UV - 2 normalized 16 bit components per vertex) (shader-location = 1)
+#else
     float *vertices;            // Vertex position (XYZ - 3 components per vertex) (shader-location = 0)
     float *texcoords;           // Vertex texture coordinates (UV - 2 components per vertex) (shader-location = 1)
+#endif
     unsigned char *colors;      // Vertex colors (RGBA - 4 components per vertex) (shader-location = 3)
 #if defined(GRAPHICS_API_OPENGL_11) || defined(GRAPHICS_API_OPENGL_33)
     unsigned int *indices;      // Vertex indices (in case vertex data comes indexed) (6 indices per quad)
@@ -384,6 +407,36 @@ typedef struct rlRenderBatch {
     float currentDepth;         // Current depth value for next draw
 } rlRenderBatch;
 
+// Vertices reserved in the active render batch, written directly by the caller
+typedef struct rlVertexSpan {
+#if defined(RLGL_BATCH_VERTEX_2D)
+    float *vertices;            // Vertex position of the first reserved vertex (XY - 2 components per vertex)
+    unsigned short *texcoords;  // Vertex texture coordinates of the first reserved vertex (UV - 2 normalized 16 bit components per vertex)
+#else
+    float *vertices;            // Vertex position of the first reserved vertex (XYZ - 3 components per vertex)
+    float *texcoords;           // Vertex texture coordinates of the first reserved vertex (UV - 2 components per vertex)
+#endif
+    unsigned char *colors;      // Vertex colors of the first reserved vertex (RGBA - 4 components per vertex)
+    float depth;                // Depth value of the current draw, Z of every 2D vertex
+    int count;                  // Number of reserved vertices, 0 if nothing could be reserved
+} rlVertexSpan;
+
+// Render batch draws forced by exhausted batch space, counted since rlglInit()
+typedef struct rlBatchExhaustion {
+    unsigned int vertexFlushes;     // Batch drawn because its vertex buffer was full
+    unsigned int drawCallFlushes;   // Batch drawn because all of its RL_DEFAULT_BATCH_DRAWCALLS were used
+} rlBatchExhaustion;
+
+// Render statistics of a frame, counted by rlgl between two rlResetFrameStats() calls (EndDrawing())
+typedef struct rlFrameStats {
+    unsigned int drawCalls;         // Draw calls issued by rlDrawRenderBatch()
+    unsigned int vertices;          // Vertex uploaded by rlDrawRenderBatch() (alignment vertex included)
+    unsigned int batchFlushes;      // rlDrawRenderBatch() calls with vertex data, one per upload
+    unsigned int exhaustedFlushes;  // Flushes forced by a full batch, see rlGetBatchExhaustion()
+    unsigned int textureSwitches;   // rlSetTexture() calls starting a new draw with another texture
+    unsigned int stateChanges;      // Shader, blend mode, framebuffer and scissor test changes
+} rlFrameStats;
+
 // OpenGL version
 typedef enum {
     RL_OPENGL_11 = 1,           // OpenGL 1.1
@@ -677,6 +730,10 @@ RLAPI void rlDrawRenderBatch(rlRenderBatch *batch);                         // D
 RLAPI void rlSetRenderBatchActive(rlRenderBatch *batch);                    // Set the active render batch for rlgl (NULL for default internal)
 RLAPI void rlDrawRenderBatchActive(void);                                   // Update and draw internal render batch
 RLAPI bool rlCheckRenderBatchLimit(int vCount);                             // Check internal buffer overflow for a given number of vertex
+RLAPI rlVertexSpan rlReserveVertices(int vCount);                           // Reserve vertex for the current draw, to be written directly
+RLAPI rlBatchExhaustion rlGetBatchExhaustion(void);                         // Get the number of batch draws forced by a full batch
+RLAPI rlFrameStats rlGetFrameStats(void);                                   // Get render statistics of the last completed frame
+RLAPI void rlResetFrameStats(void);                                         // Complete the frame statistics and start counting the next frame
 
 RLAPI void rlSetTexture(unsigned int id);               // Set current texture for render batch and check buffers limits
 
@@ -833,6 +890,13 @@ RLAPI void rlLoadDrawQuad(void);     // Load and draw a quad
 #include <string.h>                     // Required for: strcmp(), strlen() [Used in rlglInit(), on extensions loading]
 #include <math.h>                       // Required for: sqrtf(), sinf(), cosf(), floor(), log()
 
+#if defined(RL_TRACE_ZONES)
+    #include "rtrace.h"                 // Required for: RL_ZONE_BEGIN(), RL_ZONE_END()
+#elif !defined(RL_ZONE_BEGIN)
+    #define RL_ZONE_BEGIN(name)         // rlgl.h stays standalone without rtrace.h
+    #define RL_ZONE_END()
+#endif
+
 //----------------------------------------------------------------------------------
 // Defines and Macros
 //----------------------------------------------------------------------------------
@@ -1010,6 +1074,11 @@ typedef struct rlglData {
         int framebufferWidth;               // Current framebuffer width
         int framebufferHeight;              // Current framebuffer height
 
+        rlBatchExhaustion batchExhaustion;  // Batch draws forced by a full batch
+        rlFrameStats frameStats;            // Render statistics of the current frame
+        rlFrameStats lastFrameStats;        // Render statistics of the last completed frame
+        unsigned int exhaustedAtReset;      // Batch draws forced by a full batch at the last rlResetFrameStats()
+
     } State;            // Renderer state
     struct {
         bool vao;                           // VAO support (OpenGL ES2 could not support VAO extension) (GL_ARB_vertex_array_object)
@@ -1070,6 +1139,9 @@ static const char *rlGetCompressedFormatName(int format); // Get compressed form
 #endif  // GRAPHICS_API_OPENGL_33 || GRAPHICS_API_OPENGL_ES2
 
 static int rlGetPixelDataSize(int width, int height, int format);   // Get pixel data size in bytes (image or texture)
+#if defined(RLGL_BATCH_VERTEX_2D)
+static unsigned short rlNormalizeTexcoord(float value);             // Convert a texcoord to a 16 bit normalized render batch texcoord
+#endif
 
 // Auxiliar matrix math functions
 static Matrix rlMatrixIdentity(void);                       // Get identity matrix
@@ -1369,7 +1441,11 @@ void rlBegin(int mode)
             }
         }
 
-        if (RLGL.currentBatch->drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS) rlDrawRenderBatch(RLGL.currentBatch);
+        if (RLGL.currentBatch->drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS)
+        {
+            RLGL.State.batchExhaustion.drawCallFlushes++;
+            rlDrawRenderBatch(RLGL.currentBatch);
+        }
 
         RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].mode = mode;
         RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].vertexCount = 0;
@@ -1380,10 +1456,12 @@ void rlBegin(int mode)
 // Finish vertex providing
 void rlEnd(void)
 {
+#if !defined(RLGL_BATCH_VERTEX_2D)
     // NOTE: Depth increment is dependant on rlOrtho(): z-near and z-far values,
     // as well as depth buffer bit-depth (16bit or 24bit or 32bit)
     // Correct increment formula would be: depthInc = (zfar - znear)/pow(2, bits)
     RLGL.currentBatch->currentDepth += (1.0f/20000.0f);
+#endif
 }
 
 // Define one vertex (position)
@@ -1428,6 +1506,15 @@ void rlVertex3f(float x, float y, float z)
     }
 
     // Add vertices
+#if defined(RLGL_BATCH_VERTEX_2D)
+    RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].vertices[2*RLGL.State.vertexCounter] = tx;
+    RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].vertices[2*RLGL.State.vertexCounter + 1] = ty;
+    (void)tz;
+
+    // Add current texcoord
+    RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].texcoords[2*RLGL.State.vertexCounter] = rlNormalizeTexcoord(RLGL.State.texcoordx);
+    RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].texcoords[2*RLGL.State.vertexCounter + 1] = rlNormalizeTexcoord(RLGL.State.texcoordy);
+#else
     RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].vertices[3*RLGL.State.vertexCounter] = tx;
     RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].vertices[3*RLGL.State.vertexCounter + 1] = ty;
     RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].vertices[3*RLGL.State.vertexCounter + 2] = tz;
@@ -1435,6 +1522,7 @@ void rlVertex3f(float x, float y, float z)
     // Add current texcoord
     RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].texcoords[2*RLGL.State.vertexCounter] = RLGL.State.texcoordx;
     RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].texcoords[2*RLGL.State.vertexCounter + 1] = RLGL.State.texcoordy;
+#endif
 
     // WARNING: By default rlVertexBuffer struct does not store normals
 
@@ -1516,6 +1604,7 @@ void rlSetTexture(unsigned int id)
         if (RLGL.State.vertexCounter >=
             RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].elementCount*4)
         {
+            RLGL.State.batchExhaustion.vertexFlushes++;
             rlDrawRenderBatch(RLGL.currentBatch);
         }
 #endif
@@ -1546,9 +1635,14 @@ void rlSetTexture(unsigned int id)
                 }
             }
 
-            if (RLGL.currentBatch->drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS) rlDrawRenderBatch(RLGL.currentBatch);
+            if (RLGL.currentBatch->drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS)
+            {
+                RLGL.State.batchExhaustion.drawCallFlushes++;
+                rlDrawRenderBatch(RLGL.currentBatch);
+            }
 
             RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].textureId = id;
+            RLGL.State.frameStats.textureSwitches++;
             RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].vertexCount = 0;
         }
 #endif
@@ -1710,6 +1804,7 @@ void rlEnableFramebuffer(unsigned int id)
 {
 #if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)) && defined(RLGL_RENDER_TEXTURES_HINT)
     glBindFramebuffer(GL_FRAMEBUFFER, id);
+    RLGL.State.frameStats.stateChanges++;
 #endif
 }
 
@@ -1718,6 +1813,7 @@ void rlDisableFramebuffer(void)
 {
 #if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)) && defined(RLGL_RENDER_TEXTURES_HINT)
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    RLGL.State.frameStats.stateChanges++;
 #endif
 }
 
@@ -1817,10 +1913,10 @@ void rlSetCullFace(int mode)
 }
 
 // Enable scissor test
-void rlEnableScissorTest(void) { glEnable(GL_SCISSOR_TEST); }
+void rlEnableScissorTest(void) { glEnable(GL_SCISSOR_TEST); RLGL.State.frameStats.stateChanges++; }
 
 // Disable scissor test
-void rlDisableScissorTest(void) { glDisable(GL_SCISSOR_TEST); }
+void rlDisableScissorTest(void) { glDisable(GL_SCISSOR_TEST); RLGL.State.frameStats.stateChanges++; }
 
 // Scissor test
 void rlScissor(int x, int y, int width, int height) { glScissor(x, y, width, height); }
@@ -1954,6 +2050,7 @@ void rlSetBlendMode(int mode)
     if ((RLGL.State.currentBlendMode != mode) || ((mode == RL_BLEND_CUSTOM || mode == RL_BLEND_CUSTOM_SEPARATE) && RLGL.State.glCustomBlendModeModified))
     {
         rlDrawRenderBatch(RLGL.currentBatch);
+        RLGL.State.frameStats.stateChanges++;
 
         switch (mode)
         {
@@ -2565,8 +2662,13 @@ rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements)
     {
         batch.vertexBuffer[i].elementCount = bufferElements;
 
+#if defined(RLGL_BATCH_VERTEX_2D)
+        batch.vertexBuffer[i].vertices = (float *)RL_MALLOC(bufferElements*2*4*sizeof(float));        // 2 float by vertex, 4 vertex by quad
+        batch.vertexBuffer[i].texcoords = (unsigned short *)RL_MALLOC(bufferElements*2*4*sizeof(unsigned short)); // 2 short by texcoord, 4 texcoord by quad
+#else
         batch.vertexBuffer[i].vertices = (float *)RL_MALLOC(bufferElements*3*4*sizeof(float));        // 3 float by vertex, 4 vertex by quad
         batch.vertexBuffer[i].texcoords = (float *)RL_MALLOC(bufferElements*2*4*sizeof(float));       // 2 float by texcoord, 4 texcoord by quad
+#endif
         batch.vertexBuffer[i].colors = (unsigned char *)RL_MALLOC(bufferElements*4*4*sizeof(unsigned char));   // 4 float by color, 4 colors by quad
 #if defined(GRAPHICS_API_OPENGL_33)
         batch.vertexBuffer[i].indices = (unsigned int *)RL_MALLOC(bufferElements*6*sizeof(unsigned int));      // 6 int by quad (indices)
@@ -2575,8 +2677,8 @@ rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements)
         batch.vertexBuffer[i].indices = (unsigned short *)RL_MALLOC(bufferElements*6*sizeof(unsigned short));  // 6 int by quad (indices)
 #endif
 
-        for (int j = 0; j < (3*4*bufferElements); j++) batch.vertexBuffer[i].vertices[j] = 0.0f;
-        for (int j = 0; j < (2*4*bufferElements); j++) batch.vertexBuffer[i].texcoords[j] = 0.0f;
+        for (int j = 0; j < (RL_BATCH_POSITION_COMPONENTS*4*bufferElements); j++) batch.vertexBuffer[i].vertices[j] = 0.0f;
+        for (int j = 0; j < (2*4*bufferElements); j++) batch.vertexBuffer[i].texcoords[j] = 0;
         for (int j = 0; j < (4*4*bufferElements); j++) batch.vertexBuffer[i].colors[j] = 0;
 
         int k = 0;
@@ -2615,16 +2717,20 @@ rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements)
         // Vertex position buffer (shader-location = 0)
         glGenBuffers(1, &batch.vertexBuffer[i].vboId[0]);
         glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer[i].vboId[0]);
-        glBufferData(GL_ARRAY_BUFFER, bufferElements*3*4*sizeof(float), batch.vertexBuffer[i].vertices, GL_DYNAMIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, bufferElements*RL_BATCH_POSITION_COMPONENTS*4*sizeof(float), batch.vertexBuffer[i].vertices, GL_DYNAMIC_DRAW);
         glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION]);
-        glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION], 3, GL_FLOAT, 0, 0, 0);
+        glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION], RL_BATCH_POSITION_COMPONENTS, GL_FLOAT, 0, 0, 0);
 
         // Vertex texcoord buffer (shader-location = 1)
         glGenBuffers(1, &batch.vertexBuffer[i].vboId[1]);
         glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer[i].vboId[1]);
-        glBufferData(GL_ARRAY_BUFFER, bufferElements*2*4*sizeof(float), batch.vertexBuffer[i].texcoords, GL_DYNAMIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, bufferElements*2*4*sizeof(batch.vertexBuffer[i].texcoords[0]), batch.vertexBuffer[i].texcoords, GL_DYNAMIC_DRAW);
         glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01]);
+#if defined(RLGL_BATCH_VERTEX_2D)
+        glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01], 2, GL_UNSIGNED_SHORT, GL_TRUE, 0, 0);
+#else
         glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01], 2, GL_FLOAT, 0, 0, 0);
+#endif
 
         // Vertex color buffer (shader-location = 3)
         glGenBuffers(1, &batch.vertexBuffer[i].vboId[2]);
@@ -2724,27 +2830,47 @@ void rlUnloadRenderBatch(rlRenderBatch batch)
 void rlDrawRenderBatch(rlRenderBatch *batch)
 {
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    RL_ZONE_BEGIN("rlDrawRenderBatch");
+
     // Update batch vertex buffers
     //------------------------------------------------------------------------------------------------------------
     // NOTE: If there is not vertex data, buffers doesn't need to be updated (vertexCount > 0)
     // TODO: If no data changed on the CPU arrays --> No need to re-update GPU arrays (use a change detector flag?)
     if (RLGL.State.vertexCounter > 0)
     {
+        RLGL.State.frameStats.batchFlushes++;
+        RLGL.State.frameStats.vertices += RLGL.State.vertexCounter;
+
         // Activate elements VAO
         if (RLGL.ExtSupported.vao) glBindVertexArray(batch->vertexBuffer[batch->currentBuffer].vaoId);
 
+#if defined(RLGL_BATCH_ORPHAN_BUFFERS)
+        // NOTE: Every buffer is orphaned first, glBufferSubData() into a buffer
+        // a pending draw still reads from could otherwise wait until that draw is done
+        const int bufferVertexCount = batch->vertexBuffer[batch->currentBuffer].elementCount*4;
+#endif
+
         // Vertex positions buffer
         glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[0]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*3*sizeof(float), batch->vertexBuffer[batch->currentBuffer].vertices);
+#if defined(RLGL_BATCH_ORPHAN_BUFFERS)
+        glBufferData(GL_ARRAY_BUFFER, bufferVertexCount*RL_BATCH_POSITION_COMPONENTS*sizeof(float), NULL, GL_DYNAMIC_DRAW);
+#endif
+        glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*RL_BATCH_POSITION_COMPONENTS*sizeof(float), batch->vertexBuffer[batch->currentBuffer].vertices);
         //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*3*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].vertices, GL_DYNAMIC_DRAW);  // Update all buffer
 
         // Texture coordinates buffer
         glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[1]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*2*sizeof(float), batch->vertexBuffer[batch->currentBuffer].texcoords);
+#if defined(RLGL_BATCH_ORPHAN_BUFFERS)
+        glBufferData(GL_ARRAY_BUFFER, bufferVertexCount*2*sizeof(batch->vertexBuffer[batch->currentBuffer].texcoords[0]), NULL, GL_DYNAMIC_DRAW);
+#endif
+        glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*2*sizeof(batch->vertexBuffer[batch->currentBuffer].texcoords[0]), batch->vertexBuffer[batch->currentBuffer].texcoords);
         //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*2*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].texcoords, GL_DYNAMIC_DRAW); // Update all buffer
 
         // Colors buffer
         glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[2]);
+#if defined(RLGL_BATCH_ORPHAN_BUFFERS)
+        glBufferData(GL_ARRAY_BUFFER, bufferVertexCount*4*sizeof(unsigned char), NULL, GL_DYNAMIC_DRAW);
+#endif
         glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*4*sizeof(unsigned char), batch->vertexBuffer[batch->currentBuffer].colors);
         //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*4*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].colors, GL_DYNAMIC_DRAW);    // Update all buffer
 
@@ -2810,12 +2936,16 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
             {
                 // Bind vertex attrib: position (shader-location = 0)
                 glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[0]);
-                glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION], 3, GL_FLOAT, 0, 0, 0);
+                glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION], RL_BATCH_POSITION_COMPONENTS, GL_FLOAT, 0, 0, 0);
                 glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION]);
 
                 // Bind vertex attrib: texcoord (shader-location = 1)
                 glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[1]);
+#if defined(RLGL_BATCH_VERTEX_2D)
+                glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01], 2, GL_UNSIGNED_SHORT, GL_TRUE, 0, 0);
+#else
                 glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01], 2, GL_FLOAT, 0, 0, 0);
+#endif
                 glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01]);
 
                 // Bind vertex attrib: color (shader-location = 3)
@@ -2849,6 +2979,7 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
             {
                 // Bind current draw call texture, activated as GL_TEXTURE0 and Bound to sampler2D texture0 by default
                 glBindTexture(GL_TEXTURE_2D, batch->draws[i].textureId);
+                RLGL.State.frameStats.drawCalls++;
 
                 if ((batch->draws[i].mode == RL_LINES) || (batch->draws[i].mode == RL_TRIANGLES)) glDrawArrays(batch->draws[i].mode, vertexOffset, batch->draws[i].vertexCount);
                 else
@@ -2915,6 +3046,8 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
     // Change to next buffer in the list (in case of multi-buffering)
     batch->currentBuffer++;
     if (batch->currentBuffer >= batch->bufferCount) batch->currentBuffer = 0;
+
+    RL_ZONE_END();
 #endif
 }
 
@@ -2948,6 +3081,7 @@ bool rlCheckRenderBatchLimit(int vCount)
         (RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].elementCount*4))
     {
         overflow = true;
+        RLGL.State.batchExhaustion.vertexFlushes++;
 
         // Store current primitive drawing mode and texture id
         int currentMode = RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].mode;
@@ -2964,6 +3098,59 @@ bool rlCheckRenderBatchLimit(int vCount)
     return overflow;
 }
 
+// Reserve vCount vertex in the active render batch for the current draw (rlBegin()/rlSetTexture())
+// NOTE: The caller writes all of them straight into the returned arrays, the batch is drawn first if they don't fit,
+// nothing is reserved if they exceed a whole batch, with a pushed transform (it isn't applied) or on OpenGL 1.1
+rlVertexSpan rlReserveVertices(int vCount)
+{
+    rlVertexSpan span = { 0 };
+
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    if ((vCount <= 0) || RLGL.State.transformRequired) return span;
+    if (vCount >= RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].elementCount*4) return span;
+
+    rlCheckRenderBatchLimit(vCount);
+
+    rlVertexBuffer *buffer = &RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer];
+    span.vertices = buffer->vertices + RL_BATCH_POSITION_COMPONENTS*RLGL.State.vertexCounter;
+    span.texcoords = buffer->texcoords + 2*RLGL.State.vertexCounter;
+    span.colors = buffer->colors + 4*RLGL.State.vertexCounter;
+    span.depth = RLGL.currentBatch->currentDepth;
+    span.count = vCount;
+
+    RLGL.State.vertexCounter += vCount;
+    RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].vertexCount += vCount;
+#endif
+
+    return span;
+}
+
+// Get the number of batch draws forced by a full batch
+// NOTE: Each of them is an extra draw and upload within a frame, RL_DEFAULT_BATCH_BUFFER_ELEMENTS
+// or RL_DEFAULT_BATCH_DRAWCALLS could be raised if they keep growing
+rlBatchExhaustion rlGetBatchExhaustion(void)
+{
+    return RLGL.State.batchExhaustion;
+}
+
+// Get render statistics of the last completed frame
+rlFrameStats rlGetFrameStats(void)
+{
+    return RLGL.State.lastFrameStats;
+}
+
+// Complete the frame statistics and start counting the next frame
+// NOTE: Called by EndDrawing() after the batch is drawn, the frame being drawn can show the statistics of the previous one
+void rlResetFrameStats(void)
+{
+    const unsigned int exhausted = RLGL.State.batchExhaustion.vertexFlushes + RLGL.State.batchExhaustion.drawCallFlushes;
+
+    RLGL.State.frameStats.exhaustedFlushes = exhausted - RLGL.State.exhaustedAtReset;
+    RLGL.State.exhaustedAtReset = exhausted;
+    RLGL.State.lastFrameStats = RLGL.State.frameStats;
+    RLGL.State.frameStats = (rlFrameStats){ 0 };
+}
+
 // Textures data management
 //-----------------------------------------------------------------------------------------
 // Convert image data to OpenGL texture (returns OpenGL valid Id)
@@ -4131,6 +4318,7 @@ void rlSetShader(unsigned int id, int *locs)
     if (RLGL.State.currentShaderId != id)
     {
         rlDrawRenderBatch(RLGL.currentBatch);
+        RLGL.State.frameStats.stateChanges++;
         RLGL.State.currentShaderId = id;
         RLGL.State.currentShaderLocs = locs;
     }
@@ -4573,17 +4761,25 @@ static void rlLoadShaderDefault(void)
     for (int i = 0; i < RL_MAX_SHADER_LOCATIONS; i++) RLGL.State.defaultShaderLocs[i] = -1;
 
     // Vertex shader directly defined, no external file required
+    // NOTE: The 2D render batch variant takes positions without Z
+#if defined(RLGL_BATCH_VERTEX_2D)
+    #define RL_DEFAULT_SHADER_POSITION_TYPE     "vec2"
+    #define RL_DEFAULT_SHADER_POSITION          "vec4(vertexPosition, 0.0, 1.0)"
+#else
+    #define RL_DEFAULT_SHADER_POSITION_TYPE     "vec3"
+    #define RL_DEFAULT_SHADER_POSITION          "vec4(vertexPosition, 1.0)"
+#endif
     const char *defaultVShaderCode =
 #if defined(GRAPHICS_API_OPENGL_21)
     "#version 120                       \n"
-    "attribute vec3 vertexPosition;     \n"
+    "attribute " RL_DEFAULT_SHADER_POSITION_TYPE " vertexPosition; \n"
     "attribute vec2 vertexTexCoord;     \n"
     "attribute vec4 vertexColor;        \n"
     "varying vec2 fragTexCoord;         \n"
     "varying vec4 fragColor;            \n"
 #elif defined(GRAPHICS_API_OPENGL_33)
     "#version 330                       \n"
-    "in vec3 vertexPosition;            \n"
+    "in " RL_DEFAULT_SHADER_POSITION_TYPE " vertexPosition; \n"
     "in vec2 vertexTexCoord;            \n"
     "in vec4 vertexColor;               \n"
     "out vec2 fragTexCoord;             \n"
@@ -4592,7 +4788,7 @@ static void rlLoadShaderDefault(void)
 #if defined(GRAPHICS_API_OPENGL_ES2)
     "#version 100                       \n"
     "precision mediump float;           \n"     // Precision required for OpenGL ES2 (WebGL) (on some browsers)
-    "attribute vec3 vertexPosition;     \n"
+    "attribute " RL_DEFAULT_SHADER_POSITION_TYPE " vertexPosition; \n"
     "attribute vec2 vertexTexCoord;     \n"
     "attribute vec4 vertexColor;        \n"
     "varying vec2 fragTexCoord;         \n"
@@ -4603,7 +4799,7 @@ static void rlLoadShaderDefault(void)
     "{                                  \n"
     "    fragTexCoord = vertexTexCoord; \n"
     "    fragColor = vertexColor;       \n"
-    "    gl_Position = mvp*vec4(vertexPosition, 1.0); \n"
+    "    gl_Position = mvp*" RL_DEFAULT_SHADER_POSITION "; \n"
     "}                                  \n";
 
     // Fragment shader directly defined, no external file required
@@ -4766,6 +4962,17 @@ static const char *rlGetCompressedFormatName(int format)
 
 #endif  // GRAPHICS_API_OPENGL_33 || GRAPHICS_API_OPENGL_ES2
 
+#if defined(RLGL_BATCH_VERTEX_2D)
+// Convert a texcoord to a 16 bit normalized render batch texcoord
+// NOTE: Values outside [0..1] (texture wrapping) are clamped
+static unsigned short rlNormalizeTexcoord(float value)
+{
+    if (value <= 0.0f) return 0;
+    if (value >= 1.0f) return 65535;
+    return (unsigned short)(value*65535.0f + 0.5f);
+}
+#endif
+
 // Get pixel data size in bytes (image or texture)
 // NOTE: Size depends on pixel format
 static int rlGetPixelDataSize(int width, int height, int format)
@@ -58,6 +58,25 @@
 #include <math.h>       // Required for: sinf(), asinf(), cosf(), acosf(), sqrtf(), fabsf()
 #include <float.h>      // Required for: FLT_EPSILON
 #include <stdlib.h>     // Required for: RL_FREE
+#include <string.h>     // Required for: memcpy(), memset()
+
+// SIMD width used by CheckCollisionCircleRecs(), all paths evaluate the same
+// IEEE operations in the same order so their results are bit-exact
+#if defined(__AVX2__)
+    #include <immintrin.h>  // Required for: AVX2 intrinsics
+    #define COLLISION_LANES     8
+    #define COLLISION_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #include <emmintrin.h>  // Required for: SSE2 intrinsics
+    #define COLLISION_LANES     4
+    #define COLLISION_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>   // Required for: NEON intrinsics
+    #define COLLISION_LANES     4
+    #define COLLISION_NEON
+#else
+    #define COLLISION_LANES     1
+#endif
 
 //----------------------------------------------------------------------------------
 // Defines and Macros
@@ -70,6 +89,9 @@
 #ifndef SPLINE_SEGMENT_DIVISIONS
     #define SPLINE_SEGMENT_DIVISIONS      24      // Spline segment divisions
 #endif
+#ifndef RECTANGLES_BATCH_CHUNK
+    #define RECTANGLES_BATCH_CHUNK      1024      // Rectangles reserved at once by DrawRectanglesBatch()
+#endif
 
 
 //----------------------------------------------------------------------------------
@@ -746,6 +768,87 @@ void DrawRectanglePro(Rectangle rec, Vector2 origin, float rotation, Color color
 #endif
 }
 
+// Draw many color-filled rectangles, one color per rectangle
+// NOTE: Vertex space is reserved once per chunk and written straight into the render batch,
+// rectangles that can't be reserved (transform pushed, OpenGL 1.1) go through DrawRectangleRec()
+void DrawRectanglesBatch(const Rectangle *recs, const Color *colors, int count)
+{
+#if defined(SUPPORT_QUADS_DRAW_MODE)
+    const int vertexPerRec = 4;
+    const float left = texShapesRec.x/texShapes.width;
+    const float top = texShapesRec.y/texShapes.height;
+    const float right = (texShapesRec.x + texShapesRec.width)/texShapes.width;
+    const float bottom = (texShapesRec.y + texShapesRec.height)/texShapes.height;
+    const float texcoords[12] = { left, top, left, bottom, right, bottom, right, top };
+
+    rlSetTexture(texShapes.id);
+    rlBegin(RL_QUADS);
+#else
+    const int vertexPerRec = 6;
+    const float texcoords[12] = { 0 };
+
+    rlBegin(RL_TRIANGLES);
+#endif
+
+    // Texcoords are the same for every rectangle, converted once to the render batch format
+#if defined(RLGL_BATCH_VERTEX_2D)
+    unsigned short uv[12] = { 0 };
+    for (int i = 0; i < 2*vertexPerRec; i++) uv[i] = (unsigned short)(texcoords[i]*65535.0f + 0.5f);
+#else
+    float uv[12] = { 0 };
+    for (int i = 0; i < 2*vertexPerRec; i++) uv[i] = texcoords[i];
+#endif
+
+    for (int first = 0; first < count; first += RECTANGLES_BATCH_CHUNK)
+    {
+        const int chunk = ((count - first) < RECTANGLES_BATCH_CHUNK)? (count - first) : RECTANGLES_BATCH_CHUNK;
+        rlVertexSpan span = rlReserveVertices(chunk*vertexPerRec);
+
+        if (span.count == 0)
+        {
+            for (int i = first; i < first + chunk; i++) DrawRectangleRec(recs[i], colors[i]);
+            continue;
+        }
+
+        float *vertices = span.vertices;
+        unsigned char *vertexColors = span.colors;
+
+        for (int i = first; i < first + chunk; i++)
+        {
+            const float x1 = recs[i].x;
+            const float y1 = recs[i].y;
+            const float x2 = recs[i].x + recs[i].width;
+            const float y2 = recs[i].y + recs[i].height;
+
+            // Same order as DrawRectanglePro(): top-left, bottom-left, bottom-right, top-right or its two triangles
+#if defined(SUPPORT_QUADS_DRAW_MODE)
+            const float corners[12] = { x1, y1, x1, y2, x2, y2, x2, y1 };
+#else
+            const float corners[12] = { x1, y1, x1, y2, x2, y1, x2, y1, x1, y2, x2, y2 };
+#endif
+            for (int v = 0; v < vertexPerRec; v++)
+            {
+                vertices[0] = corners[2*v];
+                vertices[1] = corners[2*v + 1];
+#if !defined(RLGL_BATCH_VERTEX_2D)
+                vertices[2] = span.depth;
+#endif
+                vertices += RL_BATCH_POSITION_COMPONENTS;
+
+                memcpy(vertexColors, &colors[i], 4);
+                vertexColors += 4;
+            }
+        }
+
+        for (int i = 0; i < chunk; i++) memcpy(span.texcoords + i*2*vertexPerRec, uv, 2*vertexPerRec*sizeof(uv[0]));
+    }
+
+    rlEnd();
+#if defined(SUPPORT_QUADS_DRAW_MODE)
+    rlSetTexture(0);
+#endif
+}
+
 // Draw a vertical-gradient-filled rectangle
 // NOTE: Gradient goes from bottom (color1) to top (color2)
 void DrawRectangleGradientV(int posX, int posY, int width, int height, Color color1, Color color2)
@@ -2132,11 +2235,11 @@ bool CheckCollisionCircleRec(Vector2 center, float radius, Rectangle rec)
 {
     bool collision = false;
 
-    int recCenterX = (int)(rec.x + rec.width/2.0f);
-    int recCenterY = (int)(rec.y + rec.height/2.0f);
+    float recCenterX = rec.x + rec.width/2.0f;
+    float recCenterY = rec.y + rec.height/2.0f;
 
-    float dx = fabsf(center.x - (float)recCenterX);
-    float dy = fabsf(center.y - (float)recCenterY);
+    float dx = fabsf(center.x - recCenterX);
+    float dy = fabsf(center.y - recCenterY);
 
     if (dx > (rec.width/2.0f + radius)) { return false; }
     if (dy > (rec.height/2.0f + radius)) { return false; }
@@ -2152,6 +2255,102 @@ bool CheckCollisionCircleRec(Vector2 center, float radius, Rectangle rec)
     return collision;
 }
 
+// Check collision between circle and COLLISION_LANES rectangles, returns one bit per rectangle
+// NOTE: Distance from the circle center to the closest point of every rectangle, compared squared
+static unsigned int CheckCollisionCircleRecsBlock(Vector2 center, float radius, const float *xs, const float *ys, const float *widths, const float *heights)
+{
+#if defined(COLLISION_AVX2)
+    __m256 cx = _mm256_set1_ps(center.x);
+    __m256 cy = _mm256_set1_ps(center.y);
+    __m256 x = _mm256_loadu_ps(xs);
+    __m256 y = _mm256_loadu_ps(ys);
+    __m256 closestX = _mm256_min_ps(_mm256_max_ps(cx, x), _mm256_add_ps(x, _mm256_loadu_ps(widths)));
+    __m256 closestY = _mm256_min_ps(_mm256_max_ps(cy, y), _mm256_add_ps(y, _mm256_loadu_ps(heights)));
+    __m256 dx = _mm256_sub_ps(cx, closestX);
+    __m256 dy = _mm256_sub_ps(cy, closestY);
+    __m256 distanceSq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+
+    return (unsigned int)_mm256_movemask_ps(_mm256_cmp_ps(distanceSq, _mm256_set1_ps(radius*radius), _CMP_LE_OQ));
+#elif defined(COLLISION_SSE2)
+    __m128 cx = _mm_set1_ps(center.x);
+    __m128 cy = _mm_set1_ps(center.y);
+    __m128 x = _mm_loadu_ps(xs);
+    __m128 y = _mm_loadu_ps(ys);
+    __m128 closestX = _mm_min_ps(_mm_max_ps(cx, x), _mm_add_ps(x, _mm_loadu_ps(widths)));
+    __m128 closestY = _mm_min_ps(_mm_max_ps(cy, y), _mm_add_ps(y, _mm_loadu_ps(heights)));
+    __m128 dx = _mm_sub_ps(cx, closestX);
+    __m128 dy = _mm_sub_ps(cy, closestY);
+    __m128 distanceSq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+
+    return (unsigned int)_mm_movemask_ps(_mm_cmple_ps(distanceSq, _mm_set1_ps(radius*radius)));
+#elif defined(COLLISION_NEON)
+    // NOTE: Separate multiply and add (no vfma) to match the other paths
+    float32x4_t cx = vdupq_n_f32(center.x);
+    float32x4_t cy = vdupq_n_f32(center.y);
+    float32x4_t x = vld1q_f32(xs);
+    float32x4_t y = vld1q_f32(ys);
+    float32x4_t closestX = vminq_f32(vmaxq_f32(cx, x), vaddq_f32(x, vld1q_f32(widths)));
+    float32x4_t closestY = vminq_f32(vmaxq_f32(cy, y), vaddq_f32(y, vld1q_f32(heights)));
+    float32x4_t dx = vsubq_f32(cx, closestX);
+    float32x4_t dy = vsubq_f32(cy, closestY);
+    float32x4_t distanceSq = vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy));
+
+    const uint32_t laneBits[4] = { 1, 2, 4, 8 };
+    uint32x4_t bits = vandq_u32(vcleq_f32(distanceSq, vdupq_n_f32(radius*radius)), vld1q_u32(laneBits));
+    uint32x2_t sum = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+
+    return vget_lane_u32(vpadd_u32(sum, sum), 0);
+#else
+    float closestX = fminf(fmaxf(center.x, xs[0]), xs[0] + widths[0]);
+    float closestY = fminf(fmaxf(center.y, ys[0]), ys[0] + heights[0]);
+    float dx = center.x - closestX;
+    float dy = center.y - closestY;
+
+    return ((dx*dx + dy*dy) <= (radius*radius))? 1u : 0u;
+#endif
+}
+
+// Check collision between circle and many rectangles given as separate arrays, returns true if any collides
+// NOTE: Bit i of hitMask[i/64] is set if rectangle i collides, hitMask must hold (count + 63)/64 words
+bool CheckCollisionCircleRecs(Vector2 center, float radius, const float *xs, const float *ys, const float *widths, const float *heights, int count, unsigned long long *hitMask)
+{
+    unsigned long long any = 0;
+    int i = 0;
+
+    for (int word = 0; word < (count + 63)/64; word++) hitMask[word] = 0;
+
+    // NOTE: 64 is a multiple of COLLISION_LANES, so a block never spans two mask words
+    for (; i + COLLISION_LANES <= count; i += COLLISION_LANES)
+    {
+        unsigned long long bits = CheckCollisionCircleRecsBlock(center, radius, xs + i, ys + i, widths + i, heights + i);
+        hitMask[i/64] |= bits << (i%64);
+        any |= bits;
+    }
+
+    // Remaining rectangles go through the same SIMD path, padded with empty ones
+    if (i < count)
+    {
+        float padX[COLLISION_LANES] = { 0 };
+        float padY[COLLISION_LANES] = { 0 };
+        float padWidth[COLLISION_LANES] = { 0 };
+        float padHeight[COLLISION_LANES] = { 0 };
+
+        for (int k = 0; k < count - i; k++)
+        {
+            padX[k] = xs[i + k];
+            padY[k] = ys[i + k];
+            padWidth[k] = widths[i + k];
+            padHeight[k] = heights[i + k];
+        }
+
+        unsigned long long bits = CheckCollisionCircleRecsBlock(center, radius, padX, padY, padWidth, padHeight) & ((1ull << (count - i)) - 1);
+        hitMask[i/64] |= bits << (i%64);
+        any |= bits;
+    }
+
+    return (any != 0);
+}
+
 // Check the collision between two lines defined by two points each, returns collision point by reference
 bool CheckCollisionLines(Vector2 startPos1, Vector2 endPos1, Vector2 startPos2, Vector2 endPos2, Vector2 *collisionPoint)
 {
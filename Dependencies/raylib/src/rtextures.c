@@ -72,6 +72,7 @@
 
 #include "utils.h"              // Required for: TRACELOG()
 #include "rlgl.h"               // OpenGL abstraction layer to OpenGL 1.1, 3.3 or ES2
+#include "rtrace.h"             // Required for: RL_ZONE_BEGIN(), RL_ZONE_END()
 
 #include <stdlib.h>             // Required for: malloc(), free()
 #include <string.h>             // Required for: strlen() [Used in ImageTextEx()], strcmp() [Used in LoadImageFromMemory()]
@@ -442,6 +443,7 @@ Image LoadImageAnim(const char *fileName, int *frames)
 // WARNING: File extension must be provided in lower-case
 Image LoadImageFromMemory(const char *fileType, const unsigned char *fileData, int dataSize)
 {
+    RL_ZONE_BEGIN("LoadImageFromMemory");
     Image image = { 0 };
 
     if ((false)
@@ -595,6 +597,7 @@ Image LoadImageFromMemory(const char *fileType, const unsigned char *fileData, i
     if (image.data != NULL) TRACELOG(LOG_INFO, "IMAGE: Data loaded successfully (%ix%i | %s | %i mipmaps)", image.width, image.height, rlGetPixelFormatName(image.format), image.mipmaps);
     else TRACELOG(LOG_WARNING, "IMAGE: Failed to load image data");
 
+    RL_ZONE_END();
     return image;
 }
 
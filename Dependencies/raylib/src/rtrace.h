@@ -0,0 +1,302 @@
+/*******************************************************************************************
+*
+*   rtrace - Trace zones written to a Chrome/Perfetto trace file
+*
+*   Zones show where the time of every single frame goes on a timeline (chrome://tracing or
+*   ui.perfetto.dev), hitches that averages hide, on every thread that records zones.
+*
+*       RL_ZONE_BEGIN("EndDrawing");
+*       ...
+*       RL_ZONE_END();
+*
+*   Every thread records into its own buffer (allocated on its first zone), without locks:
+*   the recording thread only moves the write position, rlTraceFlush() only the read position.
+*   Zones are written as complete events ("ph":"X") in the JSON array format, the closing
+*   bracket is optional there, so a trace stays readable if the program never reaches rlTraceClose().
+*
+*   CONFIGURATION:
+*       #define RL_TRACE_ZONES
+*           Compiles the zones in, without it the macros are empty and cost nothing
+*
+*       #define RTRACE_IMPLEMENTATION
+*           Generates the implementation of the library into the included file.
+*           If not defined, the library is in header only mode and can be included in other headers
+*           or source files without problems. But only ONE file should hold the implementation.
+*
+*       #define RTRACE_BUFFER_ZONES     16384
+*           Zones a thread can record between two flushes, more are dropped (and counted)
+*
+*       #define RTRACE_MAX_DEPTH        32
+*           Zones a thread can have open at once, deeper ones are ignored
+*
+*   NOTE: Zone names have to outlive the trace (string literals), only the pointer is recorded.
+*   rlTraceFlush() and rlTraceClose() have to be called from the same thread.
+*
+*   LICENSE: zlib/libpng
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef RTRACE_H
+#define RTRACE_H
+
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#if defined(_WIN32)
+#if defined(BUILD_LIBTYPE_SHARED)
+#define RLAPI __declspec(dllexport)     // We are building the library as a Win32 shared library (.dll)
+#elif defined(USE_LIBTYPE_SHARED)
+#define RLAPI __declspec(dllimport)     // We are using the library as a Win32 shared library (.dll)
+#endif
+#endif
+
+#ifndef RLAPI
+    #define RLAPI       // Functions defined as 'extern' by default (implicit specifiers)
+#endif
+
+#if defined(RL_TRACE_ZONES)
+    #define RL_ZONE_BEGIN(name)     rlTraceBegin(name)
+    #define RL_ZONE_END()           rlTraceEnd()
+#else
+    #define RL_ZONE_BEGIN(name)     ((void)0)
+    #define RL_ZONE_END()           ((void)0)
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+#if defined(__cplusplus)
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+RLAPI bool rlTraceOpen(const char *fileName);   // Start writing zones to a trace file, zones before are not recorded
+RLAPI void rlTraceFlush(void);                  // Write the zones recorded so far by all threads
+RLAPI void rlTraceClose(void);                  // Flush and close the trace file
+RLAPI void rlTraceBegin(const char *name);      // Begin a zone on the calling thread, use RL_ZONE_BEGIN()
+RLAPI void rlTraceEnd(void);                    // End the last zone of the calling thread, use RL_ZONE_END()
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // RTRACE_H
+
+/***********************************************************************************
+*
+*   RTRACE IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RTRACE_IMPLEMENTATION) && !defined(RTRACE_IMPLEMENTED)
+#define RTRACE_IMPLEMENTED      // rlgl.h includes the header again inside rcore.c
+
+#include <stdio.h>      // Required for: FILE, fopen(), fprintf(), fclose()
+#include <stdlib.h>     // Required for: calloc(), free()
+
+#ifndef RTRACE_BUFFER_ZONES
+    #define RTRACE_BUFFER_ZONES     16384
+#endif
+#ifndef RTRACE_MAX_DEPTH
+    #define RTRACE_MAX_DEPTH           32
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+    #define RTRACE_THREAD_LOCAL             __declspec(thread)
+    #define RTRACE_LOAD_ACQUIRE(value)      ((unsigned int)_InterlockedOr((volatile long *)(value), 0))
+    #define RTRACE_LOAD_ACQUIRE_POINTER(value) _InterlockedCompareExchangePointer((void *volatile *)(value), NULL, NULL)
+    #define RTRACE_STORE_RELEASE(value, x)  _InterlockedExchange((volatile long *)(value), (long)(x))
+    #define RTRACE_INCREMENT(value)         ((unsigned int)_InterlockedIncrement((volatile long *)(value)))
+    #define RTRACE_PUSH(head, node)         do { (node)->next = (head); } while (_InterlockedCompareExchangePointer((void *volatile *)&(head), (node), (node)->next) != (node)->next)
+#else
+    #define RTRACE_THREAD_LOCAL             __thread
+    #define RTRACE_LOAD_ACQUIRE(value)      __atomic_load_n(value, __ATOMIC_ACQUIRE)
+    #define RTRACE_LOAD_ACQUIRE_POINTER(value) __atomic_load_n(value, __ATOMIC_ACQUIRE)
+    #define RTRACE_STORE_RELEASE(value, x)  __atomic_store_n(value, x, __ATOMIC_RELEASE)
+    #define RTRACE_INCREMENT(value)         __atomic_add_fetch(value, 1, __ATOMIC_RELAXED)
+    #define RTRACE_PUSH(head, node)         do { (node)->next = __atomic_load_n(&(head), __ATOMIC_RELAXED); } while (!__atomic_compare_exchange_n(&(head), &(node)->next, (node), true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+#endif
+
+#if defined(_WIN32)
+// NOTE: We declare the required symbols to avoid including windows.h
+__declspec(dllimport) int __stdcall QueryPerformanceCounter(long long *count);
+__declspec(dllimport) int __stdcall QueryPerformanceFrequency(long long *frequency);
+#else
+    #include <time.h>   // Required for: clock_gettime()
+#endif
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct rlTraceZone {
+    const char *name;
+    unsigned long long start;           // Nanoseconds
+    unsigned long long duration;
+} rlTraceZone;
+
+// Zones of one thread, a single producer single consumer ring
+typedef struct rlTraceBuffer {
+    struct rlTraceBuffer *next;         // All buffers, only ever pushed to
+    unsigned int thread;                // Id in the trace
+    unsigned int head;                  // Written zones, only moved by the recording thread
+    unsigned int tail;                  // Flushed zones, only moved by rlTraceFlush()
+    unsigned int dropped;               // Zones that didn't fit between two flushes
+    int depth;                          // Open zones
+    const char *openNames[RTRACE_MAX_DEPTH];
+    unsigned long long openStarts[RTRACE_MAX_DEPTH];
+    rlTraceZone zones[RTRACE_BUFFER_ZONES];
+} rlTraceBuffer;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static FILE *rlTraceFile = NULL;
+static unsigned int rlTraceRecording = 0;                       // Zones are only recorded while a file is open
+static unsigned int rlTraceThreads = 0;
+static rlTraceBuffer *rlTraceBuffers = NULL;
+static RTRACE_THREAD_LOCAL rlTraceBuffer *rlTraceThreadBuffer = NULL;
+static unsigned long long rlTraceStart = 0;                     // Timestamps in the trace start at rlTraceOpen()
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+static unsigned long long rlTraceNow(void)
+{
+#if defined(_WIN32)
+    static long long frequency = 0;
+    long long count = 0;
+    if (frequency == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&count);
+    return (unsigned long long)(count/frequency)*1000000000ULL + (unsigned long long)((count%frequency)*1000000000LL/frequency);
+#else
+    struct timespec now = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec*1000000000ULL + (unsigned long long)now.tv_nsec;
+#endif
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+bool rlTraceOpen(const char *fileName)
+{
+    if (rlTraceFile != NULL) return false;
+
+    rlTraceFile = fopen(fileName, "w");
+    if (rlTraceFile == NULL) return false;
+
+    fprintf(rlTraceFile, "[\n");
+    rlTraceStart = rlTraceNow();
+    RTRACE_STORE_RELEASE(&rlTraceRecording, 1);
+    return true;
+}
+
+void rlTraceFlush(void)
+{
+    if (rlTraceFile == NULL) return;
+
+    for (rlTraceBuffer *buffer = (rlTraceBuffer *)RTRACE_LOAD_ACQUIRE_POINTER(&rlTraceBuffers); buffer != NULL; buffer = buffer->next)
+    {
+        unsigned int head = RTRACE_LOAD_ACQUIRE(&buffer->head);
+
+        for (unsigned int i = buffer->tail; i != head; i++)
+        {
+            const rlTraceZone *zone = &buffer->zones[i%RTRACE_BUFFER_ZONES];
+            fprintf(rlTraceFile, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f},\n",
+                zone->name, buffer->thread, (double)(zone->start - rlTraceStart)/1000.0, (double)zone->duration/1000.0);
+        }
+
+        RTRACE_STORE_RELEASE(&buffer->tail, head);
+
+        unsigned int dropped = RTRACE_LOAD_ACQUIRE(&buffer->dropped);
+        if (dropped > 0)
+        {
+            // Shows up as a counter on the thread's timeline
+            fprintf(rlTraceFile, "{\"name\":\"dropped zones\",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"zones\":%u}},\n",
+                buffer->thread, (double)(rlTraceNow() - rlTraceStart)/1000.0, dropped);
+        }
+    }
+
+    fflush(rlTraceFile);
+}
+
+void rlTraceClose(void)
+{
+    if (rlTraceFile == NULL) return;
+
+    RTRACE_STORE_RELEASE(&rlTraceRecording, 0);
+    rlTraceFlush();
+
+    // Metadata instead of the closing bracket, the last comma is still valid this way
+    fprintf(rlTraceFile, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"raylib\"}}\n]\n");
+    fclose(rlTraceFile);
+    rlTraceFile = NULL;
+
+    // NOTE: Buffers stay allocated, threads that are still running keep pointing at theirs
+}
+
+void rlTraceBegin(const char *name)
+{
+    if (!RTRACE_LOAD_ACQUIRE(&rlTraceRecording)) return;
+
+    rlTraceBuffer *buffer = rlTraceThreadBuffer;
+    if (buffer == NULL)
+    {
+        buffer = (rlTraceBuffer *)calloc(1, sizeof(rlTraceBuffer));
+        if (buffer == NULL) return;
+
+        buffer->thread = RTRACE_INCREMENT(&rlTraceThreads);
+        RTRACE_PUSH(rlTraceBuffers, buffer);
+        rlTraceThreadBuffer = buffer;
+    }
+
+    if (buffer->depth < RTRACE_MAX_DEPTH)
+    {
+        buffer->openNames[buffer->depth] = name;
+        buffer->openStarts[buffer->depth] = rlTraceNow();
+    }
+
+    buffer->depth++;
+}
+
+void rlTraceEnd(void)
+{
+    rlTraceBuffer *buffer = rlTraceThreadBuffer;
+    if ((buffer == NULL) || (buffer->depth == 0)) return;
+
+    buffer->depth--;
+    if (buffer->depth >= RTRACE_MAX_DEPTH) return;
+
+    const unsigned long long end = rlTraceNow();
+    const unsigned int head = buffer->head;
+    if ((head - RTRACE_LOAD_ACQUIRE(&buffer->tail)) >= RTRACE_BUFFER_ZONES)
+    {
+        RTRACE_STORE_RELEASE(&buffer->dropped, buffer->dropped + 1);
+        return;
+    }
+
+    rlTraceZone *zone = &buffer->zones[head%RTRACE_BUFFER_ZONES];
+    zone->name = buffer->openNames[buffer->depth];
+    zone->start = buffer->openStarts[buffer->depth];
+    zone->duration = end - zone->start;
+    RTRACE_STORE_RELEASE(&buffer->head, head + 1);
+}
+
+#endif // RTRACE_IMPLEMENTATION
@@ -0,0 +1,40 @@
+project "Simulation"
+    language "C"
+    cdialect "C11"
+    kind "StaticLib"
+    flags "FatalWarnings"
+
+    filter "toolset:msc*"
+        warnings "High"
+        externalwarnings "Default"
+        buildoptions { "/sdl" }
+        disablewarnings { "4244", "4324" } -- float to int without cast, struct padded because of _Alignas
+
+    filter { "toolset:gcc* or toolset:clang*" }
+        warnings "Extra"
+        enablewarnings {
+            "shadow",
+            "undef",
+            "uninitialized",
+            "unreachable-code",
+            "unused",
+            "vla"
+        }
+        disablewarnings { "unused-parameter", "conversion", "missing-field-initializers", "unknown-warning-option" }
+
+    filter { "configurations:Release", "toolset:gcc* or toolset:clang*" }
+        buildoptions { "-ffunction-sections", "-fdata-sections" } -- places each function and data item in its own section
+
+    filter { "configurations:Release" }
+        floatingpoint "fast"
+    filter {}
+
+    files {
+        "src/**.c",
+        "src/**.h"
+    }
+
+    -- only raylib.h's plain data types are used, the simulation doesn't link against raylib
+    externalincludedirs {
+        RaylibDir .. "/src"
+    }
@@ -0,0 +1,41 @@
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "arena.h"
+
+
+bool arena_init(struct Arena* arena, size_t capacity)
+{
+    arena->memory = malloc(capacity);
+    arena->capacity = arena->memory != NULL ? capacity : 0;
+    arena->used = 0;
+    return arena->memory != NULL;
+}
+
+
+void arena_free(struct Arena* arena)
+{
+    free(arena->memory);
+    arena->memory = NULL;
+    arena->capacity = 0;
+    arena->used = 0;
+}
+
+
+void arena_reset(struct Arena* arena)
+{
+    arena->used = 0;
+}
+
+
+void* arena_alloc(struct Arena* arena, size_t size, size_t alignment)
+{
+    // align the address not just the offset, malloc doesn't guarantee more than max_align_t
+    const uintptr_t base = (uintptr_t)arena->memory;
+    const size_t offset = ((base + arena->used + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+    if (offset > arena->capacity || size > arena->capacity - offset)
+        return NULL;
+
+    arena->used = offset + size;
+    return arena->memory + offset;
+}
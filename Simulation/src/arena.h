@@ -0,0 +1,27 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/*
+    Linear allocator, memory is handed out front to back and given back all at once with arena_reset().
+    The backing memory is allocated once, so resetting and refilling it never touches the heap.
+*/
+struct Arena
+{
+    unsigned char* memory;
+    size_t capacity;
+    size_t used;
+};
+
+
+bool arena_init(struct Arena* arena, size_t capacity);
+void arena_free(struct Arena* arena);
+void arena_reset(struct Arena* arena);
+void* arena_alloc(struct Arena* arena, size_t size, size_t alignment); // NULL if the arena is exhausted
+
+#define ARENA_ALLOC_ARRAY(arena, type, count) ((type*)arena_alloc(arena, sizeof(type) * (count), _Alignof(type)))
+#define ARENA_ARRAY_SIZE(type, count) (sizeof(type) * (count) + _Alignof(type) - 1) // capacity ARENA_ALLOC_ARRAY() uses at most
+
+#endif // ARENA_H
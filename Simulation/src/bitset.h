@@ -0,0 +1,86 @@
+#ifndef BITSET_H
+#define BITSET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+#define BITSET_WORDS(bits) (((bits) + 63) / 64)
+
+
+// Index of the lowest set bit, word must not be 0
+static inline int count_trailing_zeros(uint64_t word)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    #if defined(_M_X64) || defined(_M_ARM64)
+        _BitScanForward64(&index, word);
+        return (int)index;
+    #else
+        if (_BitScanForward(&index, (unsigned long)word))
+            return (int)index;
+        _BitScanForward(&index, (unsigned long)(word >> 32));
+        return (int)index + 32;
+    #endif
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+
+static inline bool bitset_test(const uint64_t* set, size_t i)
+{
+    return (set[i / 64] >> (i % 64)) & 1;
+}
+
+
+static inline void bitset_clear(uint64_t* set, size_t i)
+{
+    set[i / 64] &= ~((uint64_t)1 << (i % 64));
+}
+
+
+// Sets the first count bits and clears the rest of the last word
+static inline void bitset_fill(uint64_t* set, size_t count)
+{
+    for (size_t i = 0; i < count / 64; ++i)
+        set[i] = ~(uint64_t)0;
+    if (count % 64 != 0)
+        set[count / 64] = ((uint64_t)1 << (count % 64)) - 1;
+}
+
+
+// The bits [from, from + 64) as one word, bits past the end of the set are 0. from must be below count
+static inline uint64_t bitset_window(const uint64_t* set, size_t count, size_t from)
+{
+    const size_t word = from / 64;
+    const size_t shift = from % 64;
+    uint64_t bits = set[word] >> shift;
+    if (shift != 0 && word + 1 < BITSET_WORDS(count))
+        bits |= set[word + 1] << (64 - shift);
+    return bits;
+}
+
+
+// Index of the first set bit at or after from, count if there is none. Empty words are skipped as a whole
+static inline size_t bitset_next(const uint64_t* set, size_t count, size_t from)
+{
+    if (from >= count)
+        return count;
+
+    size_t word = from / 64;
+    uint64_t bits = set[word] & (~(uint64_t)0 << (from % 64));
+    while (bits == 0)
+    {
+        if (++word >= BITSET_WORDS(count))
+            return count;
+        bits = set[word];
+    }
+    return word * 64 + (size_t)count_trailing_zeros(bits);
+}
+
+#endif // BITSET_H
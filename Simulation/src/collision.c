@@ -0,0 +1,85 @@
+#include <assert.h>
+
+#include "collision.h"
+#include "bitset.h"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define COLLISION_AVX2
+    #define COLLISION_LANES 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define COLLISION_SSE2
+    #define COLLISION_LANES 4
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define COLLISION_NEON
+    #define COLLISION_LANES 4
+#else
+    #define COLLISION_LANES 1
+#endif
+
+_Static_assert(64 % COLLISION_LANES == 0, "a block never spans two words of the mask");
+_Static_assert(COLLISION_OVERREAD >= COLLISION_LANES - 1, "the last block can be read whole");
+
+
+// COLLISION_LANES rectangles, bit per rectangle
+static unsigned int circle_overlaps_block(float x, float y, float radius, const float* xs, const float* ys, const float* widths, const float* heights)
+{
+#if defined(COLLISION_AVX2)
+    const __m256 cx = _mm256_set1_ps(x);
+    const __m256 cy = _mm256_set1_ps(y);
+    const __m256 rx = _mm256_loadu_ps(xs);
+    const __m256 ry = _mm256_loadu_ps(ys);
+    const __m256 dx = _mm256_sub_ps(cx, _mm256_min_ps(_mm256_max_ps(cx, rx), _mm256_add_ps(rx, _mm256_loadu_ps(widths))));
+    const __m256 dy = _mm256_sub_ps(cy, _mm256_min_ps(_mm256_max_ps(cy, ry), _mm256_add_ps(ry, _mm256_loadu_ps(heights))));
+    const __m256 distance = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+    return (unsigned int)_mm256_movemask_ps(_mm256_cmp_ps(distance, _mm256_set1_ps(radius*radius), _CMP_LE_OQ));
+#elif defined(COLLISION_SSE2)
+    const __m128 cx = _mm_set1_ps(x);
+    const __m128 cy = _mm_set1_ps(y);
+    const __m128 rx = _mm_loadu_ps(xs);
+    const __m128 ry = _mm_loadu_ps(ys);
+    const __m128 dx = _mm_sub_ps(cx, _mm_min_ps(_mm_max_ps(cx, rx), _mm_add_ps(rx, _mm_loadu_ps(widths))));
+    const __m128 dy = _mm_sub_ps(cy, _mm_min_ps(_mm_max_ps(cy, ry), _mm_add_ps(ry, _mm_loadu_ps(heights))));
+    const __m128 distance = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+    return (unsigned int)_mm_movemask_ps(_mm_cmple_ps(distance, _mm_set1_ps(radius*radius)));
+#elif defined(COLLISION_NEON)
+    // separate multiply and add, a fused one would round differently than the other paths
+    const float32x4_t cx = vdupq_n_f32(x);
+    const float32x4_t cy = vdupq_n_f32(y);
+    const float32x4_t rx = vld1q_f32(xs);
+    const float32x4_t ry = vld1q_f32(ys);
+    const float32x4_t dx = vsubq_f32(cx, vminq_f32(vmaxq_f32(cx, rx), vaddq_f32(rx, vld1q_f32(widths))));
+    const float32x4_t dy = vsubq_f32(cy, vminq_f32(vmaxq_f32(cy, ry), vaddq_f32(ry, vld1q_f32(heights))));
+    const float32x4_t distance = vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy));
+    const uint32_t lane_bits[4] = { 1, 2, 4, 8 };
+    const uint32x4_t bits = vandq_u32(vcleq_f32(distance, vdupq_n_f32(radius*radius)), vld1q_u32(lane_bits));
+    const uint32x2_t sum = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+    return vget_lane_u32(vpadd_u32(sum, sum), 0);
+#else
+    return circle_overlaps_rec(x, y, radius, (Rectangle){ xs[0], ys[0], widths[0], heights[0] });
+#endif
+}
+
+
+uint64_t circle_overlaps_recs(float x, float y, float radius, const float* xs, const float* ys, const float* widths, const float* heights, uint64_t mask)
+{
+    static const uint64_t block_mask = ((uint64_t)1 << COLLISION_LANES) - 1;
+    uint64_t hits = 0;
+
+    // jumps from one block with a rectangle of the mask to the next
+    for (uint64_t todo = mask; todo != 0;)
+    {
+        const size_t i = (size_t)count_trailing_zeros(todo) / COLLISION_LANES * COLLISION_LANES;
+        hits |= (uint64_t)circle_overlaps_block(x, y, radius, xs + i, ys + i, widths + i, heights + i) << i;
+        todo &= ~(block_mask << i);
+    }
+    hits &= mask;
+
+#ifndef NDEBUG
+    for (size_t k = 0; k < 64; ++k)
+        assert(((hits >> k) & 1) == (((mask >> k) & 1) && circle_overlaps_rec(x, y, radius, (Rectangle){ xs[k], ys[k], widths[k], heights[k] })));
+#endif
+    return hits;
+}
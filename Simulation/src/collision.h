@@ -0,0 +1,36 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "raylib.h"
+
+#define COLLISION_OVERREAD 7 // floats past the last rectangle of the mask circle_overlaps_recs() may read
+
+
+#define COLLISION_MIN(a, b) (a < b ? a : b)
+#define COLLISION_MAX(a, b) (a > b ? a : b)
+
+
+// Squared distance from the center to the closest point of the rectangle, the order of the operations is the one of the SIMD paths
+static inline bool circle_overlaps_rec(float x, float y, float radius, Rectangle rec)
+{
+    const float dx = x - COLLISION_MIN(COLLISION_MAX(x, rec.x), rec.x + rec.width);
+    const float dy = y - COLLISION_MIN(COLLISION_MAX(y, rec.y), rec.y + rec.height);
+    return dx*dx + dy*dy <= radius*radius;
+}
+
+
+/*
+    The same test against the rectangles in mask, given as separate arrays (the layout of struct Bricks). Bit i of the
+    result is set if the circle overlaps rectangle i, rectangles outside of mask are skipped and their bits are 0.
+    AVX2 tests 8 rectangles per instruction, SSE2 and NEON 4, other targets fall back to circle_overlaps_rec().
+    Blocks without a rectangle of mask aren't read, the others are read whole (see COLLISION_OVERREAD).
+    Every path does the same float operations in the same order, so the results are exactly the ones of
+    circle_overlaps_rec(), debug builds check that on every call.
+*/
+uint64_t circle_overlaps_recs(float x, float y, float radius, const float* xs, const float* ys, const float* widths, const float* heights, uint64_t mask);
+
+#endif // COLLISION_H
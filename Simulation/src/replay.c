@@ -0,0 +1,262 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "replay.h"
+
+#define REPLAY_MAGIC   "BKREPLAY"
+#define REPLAY_VERSION 1
+
+
+uint32_t game_settings_pack(const struct GameSettings* settings)
+{
+    return (uint32_t)settings->make_bottom_hitbox << 0
+        | (uint32_t)settings->paddle_has_hitbox << 1
+        | (uint32_t)settings->show_stats << 2
+        | (uint32_t)settings->increase_ball_speed << 3
+        | (uint32_t)settings->auto_restart << 4
+        | (uint32_t)settings->auto_move << 5
+        | (uint32_t)settings->event_driven << 6
+        | (uint32_t)settings->multi_ball << 7;
+}
+
+
+struct GameSettings game_settings_unpack(uint32_t bits)
+{
+    struct GameSettings settings;
+    settings.make_bottom_hitbox = bits & (1 << 0);
+    settings.paddle_has_hitbox = bits & (1 << 1);
+    settings.show_stats = bits & (1 << 2);
+    settings.increase_ball_speed = bits & (1 << 3);
+    settings.auto_restart = bits & (1 << 4);
+    settings.auto_move = bits & (1 << 5);
+    settings.event_driven = bits & (1 << 6);
+    settings.multi_ball = bits & (1 << 7);
+    return settings;
+}
+
+
+void replay_write(struct Replay* replay, const void* bytes, size_t count)
+{
+    if (replay->out_of_memory)
+        return;
+
+    if (replay->size + count > replay->capacity)
+    {
+        const size_t capacity = replay->capacity * 2 + count + 4096;
+        unsigned char* data = realloc(replay->data, capacity);
+        if (data == NULL)
+        {
+            replay->out_of_memory = true;
+            return;
+        }
+        replay->data = data;
+        replay->capacity = capacity;
+    }
+    memcpy(replay->data + replay->size, bytes, count);
+    replay->size += count;
+}
+
+
+void replay_write_u32(struct Replay* replay, uint32_t value)
+{
+    const unsigned char bytes[4] = { value & 0xFF, (value >> 8) & 0xFF, (value >> 16) & 0xFF, (value >> 24) & 0xFF };
+    replay_write(replay, bytes, sizeof(bytes));
+}
+
+
+void replay_write_f32(struct Replay* replay, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    replay_write_u32(replay, bits);
+}
+
+
+// Reads past the end return 0, replay_next() checks the size before every record
+uint32_t replay_read_u32(struct Replay* replay)
+{
+    if (replay->read + 4 > replay->size)
+    {
+        replay->read = replay->size;
+        return 0;
+    }
+    const unsigned char* bytes = replay->data + replay->read;
+    replay->read += 4;
+    return (uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+}
+
+
+float replay_read_f32(struct Replay* replay)
+{
+    const uint32_t bits = replay_read_u32(replay);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+
+void replay_record_begin(struct Replay* replay, const struct ReplayHeader* header)
+{
+    memset(replay, 0, sizeof(struct Replay));
+    replay->header = *header;
+    replay->last_settings = header->settings;
+    replay->last_speed = header->ball_speed;
+}
+
+
+void replay_record_step(struct Replay* replay, const struct GameState* state, const struct InputFrame* input)
+{
+    // keys change settings and the ball speed between steps, only differences go into the stream
+    const uint32_t settings = game_settings_pack(&state->settings);
+    if (settings != replay->last_settings || state->objects.ball.speed != replay->last_speed)
+    {
+        const unsigned char record = REPLAY_SETTINGS;
+        replay_write(replay, &record, 1);
+        replay_write_u32(replay, settings);
+        replay_write_f32(replay, state->objects.ball.speed);
+        replay->last_settings = settings;
+    }
+
+    const unsigned char actions = (unsigned char)(input->actions & (InputMoveLeft | InputMoveRight | InputMouseMoved | InputSpawnBalls));
+    replay_write(replay, &actions, 1);
+    if (actions & InputMouseMoved)
+        replay_write_f32(replay, input->mouse_x);
+}
+
+
+void replay_record_end_step(struct Replay* replay, const struct GameState* state)
+{
+    replay->last_speed = state->objects.ball.speed; // the simulation changes it on its own
+}
+
+
+void replay_record_reset(struct Replay* replay, float ball_speed)
+{
+    const unsigned char record = REPLAY_RESET;
+    replay_write(replay, &record, 1);
+    replay_write_f32(replay, ball_speed);
+    replay->last_speed = ball_speed;
+}
+
+
+bool replay_save(const struct Replay* replay, const char* path)
+{
+    if (replay->out_of_memory)
+        return false;
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL)
+        return false;
+
+    // the header goes through the same little endian writer as the stream
+    struct Replay header = { 0 };
+    const struct ReplayHeader* h = &replay->header;
+    replay_write(&header, REPLAY_MAGIC, 8);
+    replay_write_u32(&header, REPLAY_VERSION);
+    replay_write_u32(&header, h->rate);
+    replay_write_f32(&header, h->width);
+    replay_write_f32(&header, h->height);
+    replay_write_u32(&header, (uint32_t)h->bricks_hor);
+    replay_write_u32(&header, (uint32_t)h->bricks_ver);
+    replay_write_u32(&header, (uint32_t)h->paddle_width);
+    replay_write_u32(&header, (uint32_t)h->paddle_height);
+    replay_write_f32(&header, h->ball_speed);
+    replay_write_u32(&header, (uint32_t)h->seed);
+    replay_write_u32(&header, (uint32_t)(h->seed >> 32));
+    replay_write_u32(&header, h->settings);
+    replay_write_u32(&header, (uint32_t)replay->size);
+
+    bool ok = !header.out_of_memory && fwrite(header.data, 1, header.size, file) == header.size;
+    ok = ok && fwrite(replay->data, 1, replay->size, file) == replay->size;
+    free(header.data);
+    return fclose(file) == 0 && ok;
+}
+
+
+bool replay_load(struct Replay* replay, const char* path)
+{
+    memset(replay, 0, sizeof(struct Replay));
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+        return false;
+
+    // the header is read through the stream reader as well, then the stream replaces it
+    unsigned char bytes[60];
+    struct Replay header = { 0 };
+    header.data = bytes;
+    header.size = fread(bytes, 1, sizeof(bytes), file);
+    if (header.size != sizeof(bytes) || memcmp(bytes, REPLAY_MAGIC, 8) != 0)
+    {
+        fclose(file);
+        return false;
+    }
+
+    header.read = 8;
+    struct ReplayHeader* h = &replay->header;
+    const uint32_t version = replay_read_u32(&header);
+    h->rate = replay_read_u32(&header);
+    h->width = replay_read_f32(&header);
+    h->height = replay_read_f32(&header);
+    h->bricks_hor = (int32_t)replay_read_u32(&header);
+    h->bricks_ver = (int32_t)replay_read_u32(&header);
+    h->paddle_width = (int32_t)replay_read_u32(&header);
+    h->paddle_height = (int32_t)replay_read_u32(&header);
+    h->ball_speed = replay_read_f32(&header);
+    h->seed = replay_read_u32(&header);
+    h->seed |= (uint64_t)replay_read_u32(&header) << 32;
+    h->settings = replay_read_u32(&header);
+    const size_t size = replay_read_u32(&header);
+
+    replay->data = malloc(size + 1);
+    bool ok = version == REPLAY_VERSION && h->rate > 0 && replay->data != NULL && fread(replay->data, 1, size, file) == size;
+    fclose(file);
+    if (!ok)
+    {
+        replay_free(replay);
+        return false;
+    }
+
+    replay->size = size;
+    replay->capacity = size + 1;
+    replay->last_settings = h->settings;
+    replay->last_speed = h->ball_speed;
+    return true;
+}
+
+
+enum ReplayItem replay_next(struct Replay* replay, struct GameState* state, struct InputFrame* input, float* reset_speed)
+{
+    while (replay->read < replay->size)
+    {
+        const unsigned char record = replay->data[replay->read++];
+        if (record & REPLAY_RESET)
+        {
+            *reset_speed = replay_read_f32(replay);
+            return ReplayReset;
+        }
+
+        if (record & REPLAY_SETTINGS)
+        {
+            replay->last_settings = replay_read_u32(replay);
+            state->settings = game_settings_unpack(replay->last_settings);
+            state->objects.ball.speed = replay_read_f32(replay);
+            continue;
+        }
+
+        input->actions = record;
+        input->mouse_x = record & InputMouseMoved ? replay_read_f32(replay) : 0;
+        return ReplayStep;
+    }
+    return ReplayEnd;
+}
+
+
+void replay_free(struct Replay* replay)
+{
+    free(replay->data);
+    replay->data = NULL;
+    replay->size = 0;
+    replay->capacity = 0;
+    replay->read = 0;
+}
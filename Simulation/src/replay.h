@@ -0,0 +1,75 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "simulation.h"
+
+/*
+    Game level replay, the input of every fixed step instead of raw key states per frame.
+    The simulation is deterministic, so the header (everything game_objects_init() needs)
+    and the input stream reproduce a session exactly, at any speed and without a window.
+
+    Stream, one record per step, little endian:
+        u8 actions (InputAction bits), f32 mouse_x only if InputMouseMoved is set
+    Records with the high bits set come before a step:
+        REPLAY_SETTINGS  u32 packed GameSettings, f32 ball speed (changed outside the simulation, e.g. by a key)
+        REPLAY_RESET     f32 ball speed (game_objects_init() was called, e.g. after a win)
+*/
+#define REPLAY_SETTINGS 0x40
+#define REPLAY_RESET    0x80
+
+
+struct ReplayHeader
+{
+    uint32_t rate; // fixed steps per second
+    float width;
+    float height;
+    int32_t bricks_hor;
+    int32_t bricks_ver;
+    int32_t paddle_width;
+    int32_t paddle_height;
+    float ball_speed;
+    uint64_t seed; // passed to game_objects_seed()
+    uint32_t settings;
+};
+
+
+enum ReplayItem
+{
+    ReplayEnd,
+    ReplayStep,
+    ReplayReset // the caller has to call game_objects_init() with the speed from replay_next()
+};
+
+
+struct Replay
+{
+    struct ReplayHeader header;
+    unsigned char* data; // the stream, grows while recording
+    size_t size;
+    size_t capacity;
+    size_t read;
+    bool out_of_memory; // while recording, the replay is incomplete and won't be saved
+    uint32_t last_settings; // what the stream last said, changes are recorded when they differ
+    float last_speed;
+};
+
+
+uint32_t game_settings_pack(const struct GameSettings* settings);
+struct GameSettings game_settings_unpack(uint32_t bits);
+
+void replay_record_begin(struct Replay* replay, const struct ReplayHeader* header);
+void replay_record_step(struct Replay* replay, const struct GameState* state, const struct InputFrame* input); // before game_step()
+void replay_record_end_step(struct Replay* replay, const struct GameState* state); // after game_step()
+void replay_record_reset(struct Replay* replay, float ball_speed);
+bool replay_save(const struct Replay* replay, const char* path);
+
+bool replay_load(struct Replay* replay, const char* path);
+// Applies recorded settings to state and fills input for the next step
+enum ReplayItem replay_next(struct Replay* replay, struct GameState* state, struct InputFrame* input, float* reset_speed);
+void replay_free(struct Replay* replay);
+
+#endif // REPLAY_H
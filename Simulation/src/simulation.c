@@ -0,0 +1,1038 @@
+#include <math.h>
+#include <string.h>
+
+#include "simulation.h"
+#include "collision.h"
+
+#define MIN(a, b) (a < b ? a : b)
+#define MAX(a, b) (a > b ? a : b)
+
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof(*a))
+
+#define BALL_MAX_IMPACTS     16        // per step, the remaining time of the step is dropped after that
+#define BALL_MAX_EVENTS      (1 << 20) // per step in event driven mode, guards against a ball stuck between colliders
+#define BALLS_PARALLEL_MIN   2048      // fewer extra balls than this aren't worth waking the thread pool for
+#define CONTACT_LOST         UINT32_MAX
+
+
+// What happened to an extra ball during the parallel phase, brick is CONTACT_LOST if it went through the bottom
+struct BallContact
+{
+    uint32_t ball;
+    uint32_t brick;
+};
+
+
+// Every worker writes its contacts compactly to the start of its own range of balls in the contacts array
+struct BallsWorker
+{
+    _Alignas(64) size_t first; // on its own cache line, the workers write to these concurrently
+    size_t contacts;
+    unsigned int flags;
+};
+
+
+struct BallsPhase
+{
+    struct GameState* state;
+    float dt;
+    struct BallsWorker workers[THREAD_POOL_MAX];
+};
+
+
+// Places every brick in its grid cell, dead ones included since nothing reads them
+void bricks_layout(struct GameObjects* objects, int window_width, float brick_height)
+{
+    struct BrickGrid* grid = &objects->grid;
+    grid->x = 0;
+    grid->y = BRICK_Y_OFFSET;
+    grid->cell_width = window_width / (float)grid->cols;
+    grid->cell_height = brick_height + MIN(BRICK_ROW_GAP, brick_height / 4);
+
+    // the gaps shrink with the bricks in large layouts
+    const float padding = MIN(BRICK_PADDING, grid->cell_width / 8);
+    const float brick_width = grid->cell_width - padding*2;
+
+    struct Bricks* bricks = &objects->bricks;
+    for (size_t i = 0; i < bricks->count; ++i)
+    {
+        bricks->x[i] = grid->x + (i % grid->cols) * grid->cell_width + padding;
+        bricks->y[i] = grid->y + (i / grid->cols) * grid->cell_height;
+        bricks->width[i] = brick_width;
+        bricks->height[i] = brick_height;
+    }
+}
+
+
+void generate_bricks(struct GameObjects* objects, int window_width, int paddle_height)
+{
+    const Color colors[BRICKS_VER] = { RED, ORANGE, YELLOW, GREEN, BLUE, PURPLE, SKYBLUE };
+    for (size_t i = 0; i < objects->bricks.count; ++i)
+        objects->bricks.color[i] = colors[(i / objects->grid.cols) % BRICKS_VER];
+    bitset_fill(objects->bricks.alive, objects->bricks.count);
+
+    // more rows than the default get thinner so the field keeps its height
+    const float brick_height = paddle_height * MIN(1.f, BRICKS_VER / (float)objects->grid.rows);
+    bricks_layout(objects, window_width, brick_height);
+}
+
+
+int grid_clamp_cell(float cell, int count)
+{
+    return (int)MAX(0.f, MIN(cell, count - 1.f));
+}
+
+
+// Time until a circle moving with velocity touches the rectangle, only contacts within max_time count.
+// The normal is the axis the circle has to be reflected on.
+bool sweep_circle_rec(Vector2 center, Vector2 velocity, float radius, Rectangle rec, float max_time, float* toi, Vector2* normal)
+{
+    const float closest_x = MAX(rec.x, MIN(center.x, rec.x + rec.width));
+    const float closest_y = MAX(rec.y, MIN(center.y, rec.y + rec.height));
+    const float dx = center.x - closest_x;
+    const float dy = center.y - closest_y;
+
+    // already touching, only a hit if we are moving into the rectangle
+    if (dx*dx + dy*dy <= radius*radius)
+    {
+        if (dx == 0 && dy == 0)
+            *normal = fabsf(velocity.x) > fabsf(velocity.y) ? (Vector2){ velocity.x > 0 ? -1.f : 1.f, 0 } : (Vector2){ 0, velocity.y > 0 ? -1.f : 1.f };
+        else
+            *normal = fabsf(dx) > fabsf(dy) ? (Vector2){ dx > 0 ? 1.f : -1.f, 0 } : (Vector2){ 0, dy > 0 ? 1.f : -1.f };
+        *toi = 0;
+        return normal->x * velocity.x + normal->y * velocity.y < 0;
+    }
+
+    // slab test against the rectangle grown by the radius
+    const float min[2] = { rec.x - radius, rec.y - radius };
+    const float max[2] = { rec.x + rec.width + radius, rec.y + rec.height + radius };
+    const float origin[2] = { center.x, center.y };
+    const float dir[2] = { velocity.x, velocity.y };
+
+    float t_enter = 0;
+    float t_exit = max_time;
+    int enter_axis = -1;
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        if (dir[axis] == 0)
+        {
+            if (origin[axis] < min[axis] || origin[axis] > max[axis])
+                return false;
+            continue;
+        }
+
+        float t_near = (min[axis] - origin[axis]) / dir[axis];
+        float t_far  = (max[axis] - origin[axis]) / dir[axis];
+        if (t_near > t_far)
+        {
+            const float tmp = t_near;
+            t_near = t_far;
+            t_far = tmp;
+        }
+
+        if (t_near > t_enter)
+        {
+            t_enter = t_near;
+            enter_axis = axis;
+        }
+        t_exit = MIN(t_exit, t_far);
+        if (t_enter > t_exit)
+            return false;
+    }
+
+    // the corners of the grown rectangle are rounded, there only the circle around the corner counts
+    const Vector2 hit = { center.x + velocity.x * t_enter, center.y + velocity.y * t_enter };
+    const bool outside_x = hit.x < rec.x || hit.x > rec.x + rec.width;
+    const bool outside_y = hit.y < rec.y || hit.y > rec.y + rec.height;
+    if (enter_axis == -1 || (outside_x && outside_y))
+    {
+        const Vector2 corner = { hit.x < rec.x ? rec.x : rec.x + rec.width, hit.y < rec.y ? rec.y : rec.y + rec.height };
+        const Vector2 m = { center.x - corner.x, center.y - corner.y };
+        const float a = velocity.x * velocity.x + velocity.y * velocity.y;
+        const float b = m.x * velocity.x + m.y * velocity.y;
+        const float c = m.x * m.x + m.y * m.y - radius * radius;
+        const float discriminant = b * b - a * c;
+        if (a == 0 || b >= 0 || discriminant < 0)
+            return false;
+
+        const float t = (-b - sqrtf(discriminant)) / a;
+        if (t < 0 || t > max_time)
+            return false;
+
+        const Vector2 n = { m.x + velocity.x * t, m.y + velocity.y * t };
+        *normal = fabsf(n.x) > fabsf(n.y) ? (Vector2){ n.x > 0 ? 1.f : -1.f, 0 } : (Vector2){ 0, n.y > 0 ? 1.f : -1.f };
+        *toi = t;
+        return true;
+    }
+
+    *normal = enter_axis == 0 ? (Vector2){ dir[0] > 0 ? -1.f : 1.f, 0 } : (Vector2){ 0, dir[1] > 0 ? -1.f : 1.f };
+    *toi = t_enter;
+    return true;
+}
+
+
+void tail_set_vertical_collision(struct Ball* ball, int from_above)
+{
+    const float radius = from_above ? ball->radius : -ball->radius;
+    ball->tail.p3.x = (ball->tail.p1.x + ball->tail.p2.x) / 2.f;
+    ball->tail.p3.y = (ball->tail.p1.y + ball->tail.p2.y) / 2.f;
+
+    ball->tail.p1.x = ball->center.x - ball->radius * 0.5f;
+    ball->tail.p1.y = ball->center.y + radius;
+
+    ball->tail.p2.x = ball->center.x + ball->radius * 0.5f;
+    ball->tail.p2.y = ball->center.y + radius;
+}
+
+
+void tail_set_horizontal_collision(struct Ball* ball, int right_wall)
+{
+    const float radius = right_wall ? ball->radius : -ball->radius;
+    ball->tail.p3.x = (ball->tail.p1.x + ball->tail.p2.x) / 2.f;
+    ball->tail.p3.y = (ball->tail.p1.y + ball->tail.p2.y) / 2.f;
+
+    ball->tail.p1.x = ball->center.x + radius;
+    ball->tail.p1.y = ball->center.y - ball->radius * 0.5f;
+
+    ball->tail.p2.x = ball->center.x + radius;
+    ball->tail.p2.y = ball->center.y + ball->radius * 0.5f;
+}
+
+
+Vector2 ball_calculate_reflected_direction(Vector2 normal, Vector2 current_direction)
+{
+    const float dot_product = current_direction.x * normal.x + current_direction.y * normal.y;
+
+    Vector2 reflected_direction;
+    reflected_direction.x = current_direction.x - 2.0f * dot_product * normal.x;
+    reflected_direction.y = current_direction.y - 2.0f * dot_product * normal.y;
+    return reflected_direction;
+}
+
+
+void ball_move_tail_tip(struct Ball* ball, float speed, float dt)
+{
+    ball->tail.p3.x += ball->prev_direction.x * dt * speed;
+    ball->tail.p3.y += ball->prev_direction.y * dt * speed;
+}
+
+
+void ball_animate_tail(struct Ball* ball, float dt)
+{
+    static const float speed_multiply = 0.9f;
+    const float speed = ball->speed * speed_multiply;
+
+    // p1 is left p2 is right
+    // if from upper left to lower right
+    if ((ball->prev_direction.y > 0 && ball->prev_direction.x > 0)
+        && ((ball->tail.p1.x == ball->tail.p2.x && ball->tail.p3.x < ball->tail.p1.x)
+            || (ball->tail.p1.y == ball->tail.p2.y && ball->tail.p3.y < ball->tail.p1.y))
+        )
+    {
+        ball_move_tail_tip(ball, speed, dt);
+    }
+    // if from lower left to upper right
+    else if ((ball->prev_direction.x > 0 && ball->prev_direction.y < 0)
+        && ((ball->tail.p1.x == ball->tail.p2.x && ball->tail.p3.x < ball->tail.p1.x)
+            || (ball->tail.p1.y == ball->tail.p2.y && ball->tail.p3.y > ball->tail.p1.y))
+        )
+    {
+        ball_move_tail_tip(ball, speed, dt);
+    }
+    // if from upper right to lower left
+    else if ((ball->prev_direction.x < 0 && ball->prev_direction.y > 0)
+        && ((ball->tail.p1.x == ball->tail.p2.x && ball->tail.p3.x > ball->tail.p1.x)
+            || (ball->tail.p1.y == ball->tail.p2.y && ball->tail.p3.y < ball->tail.p1.y))
+        )
+    {
+        ball_move_tail_tip(ball, speed, dt);
+    }
+    // if from lower right to upper left
+    else if ((ball->prev_direction.x < 0 && ball->prev_direction.y < 0)
+        && ((ball->tail.p1.x == ball->tail.p2.x && ball->tail.p3.x > ball->tail.p1.x)
+            || (ball->tail.p1.y == ball->tail.p2.y && ball->tail.p3.y > ball->tail.p1.y))
+        )
+    {
+        ball_move_tail_tip(ball, speed, dt);
+    }
+    else
+    {
+        ball->tail.p3.x = (ball->tail.p1.x + ball->tail.p2.x) / 2.f;
+        ball->tail.p3.y = (ball->tail.p1.y + ball->tail.p2.y) / 2.f;
+    }
+}
+
+
+Vector2 ball_velocity(const struct Ball* ball)
+{
+    return (Vector2){ ball->direction.x * ball->speed, ball->direction.y * ball->speed };
+}
+
+
+// The ball_*_impact functions replace the impact if they find an earlier one
+void ball_walls_impact(const struct GameState* state, struct Impact* impact)
+{
+    const struct Ball* ball = &state->objects.ball;
+    const Vector2 velocity = ball_velocity(ball);
+
+    // the ball is only stopped by a wall it is moving towards
+    float toi;
+    if (velocity.x < 0 && (toi = (ball->radius - ball->center.x) / velocity.x) <= impact->toi)
+    {
+        *impact = (struct Impact){ MAX(toi, 0), { 1, 0 }, ImpactWall, 0 };
+    }
+    if (velocity.x > 0 && (toi = (state->width - ball->radius - ball->center.x) / velocity.x) <= impact->toi)
+    {
+        *impact = (struct Impact){ MAX(toi, 0), { -1, 0 }, ImpactWall, 0 };
+    }
+    if (velocity.y < 0 && (toi = (ball->radius - ball->center.y) / velocity.y) <= impact->toi)
+    {
+        *impact = (struct Impact){ MAX(toi, 0), { 0, 1 }, ImpactWall, 0 };
+    }
+    if (velocity.y > 0 && (toi = (state->height - ball->radius - ball->center.y) / velocity.y) <= impact->toi)
+    {
+        *impact = (struct Impact){ MAX(toi, 0), { 0, -1 }, state->settings.make_bottom_hitbox ? ImpactWall : ImpactBottom, 0 };
+    }
+}
+
+
+void ball_paddle_impact(const struct GameState* state, struct Impact* impact)
+{
+    const struct Ball* ball = &state->objects.ball;
+    const Vector2 velocity = ball_velocity(ball);
+    if (!state->settings.paddle_has_hitbox || velocity.y <= 0)
+        return;
+
+    float toi;
+    Vector2 normal;
+    // an auto moved paddle is always right below the ball when it comes down, no matter how fast it is
+    if (state->settings.auto_move)
+    {
+        toi = (state->objects.paddle.y - ball->radius - ball->center.y) / velocity.y;
+        if (toi >= 0 && toi <= impact->toi)
+            *impact = (struct Impact){ toi, { 0, -1 }, ImpactPaddle, 0 };
+    }
+    else if (sweep_circle_rec(ball->center, velocity, ball->radius, state->objects.paddle, impact->toi, &toi, &normal))
+    {
+        *impact = (struct Impact){ toi, normal, ImpactPaddle, 0 };
+    }
+}
+
+
+// Only visits the cells the swept ball overlaps, row by row
+void ball_bricks_impact(const struct GameState* state, struct Impact* impact)
+{
+    const struct Ball* ball = &state->objects.ball;
+    const Vector2 velocity = ball_velocity(ball);
+    const struct Bricks* bricks = &state->objects.bricks;
+    const struct BrickGrid* grid = &state->objects.grid;
+    const float max_time = impact->toi;
+
+    const float end_y = ball->center.y + velocity.y * max_time;
+    const float top = MIN(ball->center.y, end_y) - ball->radius;
+    const float bottom = MAX(ball->center.y, end_y) + ball->radius;
+    if (bottom < grid->y || top > grid->y + grid->cell_height * grid->rows)
+        return;
+
+    const int first_row = grid_clamp_cell(floorf((top - grid->y) / grid->cell_height), grid->rows);
+    const int last_row = grid_clamp_cell(floorf((bottom - grid->y) / grid->cell_height), grid->rows);
+    for (int row = first_row; row <= last_row; ++row)
+    {
+        // part of the sweep that is inside this row
+        float t_from = 0;
+        float t_to = max_time;
+        if (velocity.y != 0)
+        {
+            const float row_top = grid->y + row * grid->cell_height - ball->radius;
+            const float row_bottom = row_top + grid->cell_height + ball->radius * 2;
+            const float t_top = (row_top - ball->center.y) / velocity.y;
+            const float t_bottom = (row_bottom - ball->center.y) / velocity.y;
+            t_from = MAX(t_from, MIN(t_top, t_bottom));
+            t_to = MIN(t_to, MAX(t_top, t_bottom));
+            if (t_from > t_to)
+                continue;
+        }
+
+        const float x_from = ball->center.x + velocity.x * t_from;
+        const float x_to = ball->center.x + velocity.x * t_to;
+        const int first_col = grid_clamp_cell(floorf((MIN(x_from, x_to) - ball->radius - grid->x) / grid->cell_width), grid->cols);
+        const int last_col = grid_clamp_cell(floorf((MAX(x_from, x_to) + ball->radius - grid->x) / grid->cell_width), grid->cols);
+
+        float toi;
+        Vector2 normal;
+        // the cells of a row are consecutive indices, only the alive ones are swept
+        const size_t row_start = (size_t)row * grid->cols;
+        const size_t end = row_start + last_col + 1;
+        for (size_t i = bitset_next(bricks->alive, end, row_start + first_col); i < end; i = bitset_next(bricks->alive, end, i + 1))
+        {
+            const Rectangle rec = { bricks->x[i], bricks->y[i], bricks->width[i], bricks->height[i] };
+            if (sweep_circle_rec(ball->center, velocity, ball->radius, rec, impact->toi, &toi, &normal) && toi < impact->toi)
+            {
+                *impact = (struct Impact){ toi, normal, ImpactBrick, i };
+            }
+        }
+    }
+}
+
+
+bool ball_find_impact(const struct GameState* state, float max_time, struct Impact* impact)
+{
+    impact->kind = ImpactNone;
+    impact->toi = max_time;
+    ball_walls_impact(state, impact);
+    ball_paddle_impact(state, impact);
+    ball_bricks_impact(state, impact);
+    return impact->kind != ImpactNone;
+}
+
+
+void ball_reflect(struct Ball* ball, Vector2 normal)
+{
+    static const Vector2 normal_hor = { .x = 1, .y = 0 };
+    static const Vector2 normal_ver = { .x = 0, .y = 1 };
+
+    if (normal.x != 0)
+    {
+        tail_set_horizontal_collision(ball, ball->direction.x > 0);
+        ball->direction = ball_calculate_reflected_direction(normal_hor, ball->direction);
+    }
+    else
+    {
+        tail_set_vertical_collision(ball, ball->direction.y > 0);
+        ball->direction = ball_calculate_reflected_direction(normal_ver, ball->direction);
+    }
+}
+
+
+void paddle_follow_ball(struct GameState* state)
+{
+    Rectangle* paddle = &state->objects.paddle;
+    paddle->x = state->objects.ball.center.x - paddle->width / 2.f;
+    paddle->x = MIN(paddle->x, state->width - paddle->width);
+    paddle->x = MAX(0, paddle->x);
+}
+
+
+// Fans count balls out of the main ball in the upper half circle, as many as there is room for
+void extra_balls_spawn(struct GameState* state, size_t count)
+{
+    struct ExtraBalls* balls = &state->objects.extra_balls;
+    const struct Ball* ball = &state->objects.ball;
+    count = MIN(count, balls->capacity - balls->count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float angle = PI * (i + 1) / (count + 1);
+        const size_t k = balls->count++;
+        balls->x[k] = ball->center.x;
+        balls->y[k] = ball->center.y;
+        balls->velocity_x[k] = cosf(angle) * ball->speed;
+        balls->velocity_y[k] = -sinf(angle) * ball->speed;
+    }
+}
+
+
+// Bookkeeping of a brick hit by any ball
+void brick_hit(struct GameState* state, size_t brick, struct GameEvents* events)
+{
+    bitset_clear(state->objects.bricks.alive, brick);
+    events->flags |= EventHitBrick;
+    events->bricks_hit++;
+    state->objects.score++;
+    if (state->settings.multi_ball && state->objects.score % MULTI_BALL_EVERY == 0)
+        extra_balls_spawn(state, MULTI_BALL_SPAWN);
+}
+
+
+void ball_resolve_impact(struct GameState* state, const struct Impact* impact, struct GameEvents* events)
+{
+    struct Ball* ball = &state->objects.ball;
+    if (impact->kind == ImpactPaddle && state->settings.auto_move)
+        paddle_follow_ball(state);
+
+    const Rectangle paddle = state->objects.paddle;
+    ball->prev_direction = ball->direction;
+
+    switch (impact->kind)
+    {
+    case ImpactWall:
+        ball_reflect(ball, impact->normal);
+        break;
+    case ImpactPaddle:
+        tail_set_vertical_collision(ball, ball->direction.y > 0);
+        // if you hit the ball in the first 25 % the ball goes back the direction reverses
+        // if going from left to right                                                    if going from right to left
+        if ((ball->direction.x > 0 && ball->center.x < paddle.x + paddle.width * 0.25) || (ball->direction.x < 0 && ball->center.x > paddle.x + paddle.width * 0.75))
+        {
+            ball->direction.x = -ball->direction.x;
+            ball->direction.y = -ball->direction.y;
+        }
+        else
+        {
+            ball->direction = ball_calculate_reflected_direction((Vector2){ 0, 1 }, ball->direction);
+        }
+        events->flags |= EventHitPaddle;
+        break;
+    case ImpactBrick:
+        ball_reflect(ball, impact->normal);
+        brick_hit(state, impact->brick, events);
+        if (state->settings.increase_ball_speed)
+            ball->speed += 6.f;
+        break;
+    case ImpactBottom:
+    case ImpactNone:
+    default:
+        break;
+    }
+}
+
+
+bool ball_move(struct GameState* state, float dt, struct GameEvents* events)
+{
+    struct Ball* ball = &state->objects.ball;
+    ball_animate_tail(ball, dt);
+
+    if (!state->settings.make_bottom_hitbox && ball->center.y + ball->radius >= state->height)
+        return false;
+
+    // advance from one impact to the next, this way the ball can't tunnel through anything no matter how fast it is
+    float remaining = dt;
+    for (int i = 0; i < BALL_MAX_IMPACTS && remaining > 0; ++i)
+    {
+        struct Impact impact;
+        const bool hit = ball_find_impact(state, remaining, &impact);
+
+        ball->center.x += ball->direction.x * ball->speed * impact.toi;
+        ball->center.y += ball->direction.y * ball->speed * impact.toi;
+        remaining -= impact.toi;
+
+        if (!hit)
+            return true;
+        if (impact.kind == ImpactBottom)
+            return false;
+        ball_resolve_impact(state, &impact, events);
+    }
+    return true;
+}
+
+
+void event_queue_swap(struct EventQueue* queue, size_t a, size_t b)
+{
+    const struct Event tmp = queue->events[a];
+    queue->events[a] = queue->events[b];
+    queue->events[b] = tmp;
+}
+
+
+void event_queue_sift_down(struct EventQueue* queue, size_t i)
+{
+    for (;;)
+    {
+        const size_t left = i * 2 + 1;
+        const size_t right = left + 1;
+        size_t smallest = i;
+        if (left < queue->size && queue->events[left].time < queue->events[smallest].time)
+            smallest = left;
+        if (right < queue->size && queue->events[right].time < queue->events[smallest].time)
+            smallest = right;
+        if (smallest == i)
+            return;
+        event_queue_swap(queue, i, smallest);
+        i = smallest;
+    }
+}
+
+
+void event_queue_push(struct EventQueue* queue, struct Event event)
+{
+    // events of an older epoch will never be handled, make room by dropping them
+    if (queue->size == EVENT_QUEUE_CAPACITY)
+    {
+        size_t kept = 0;
+        for (size_t i = 0; i < queue->size; ++i)
+        {
+            if (queue->events[i].epoch == queue->epochs[queue->events[i].collider])
+                queue->events[kept++] = queue->events[i];
+        }
+        queue->size = kept;
+        for (size_t i = queue->size / 2; i-- > 0;)
+            event_queue_sift_down(queue, i);
+    }
+
+    size_t i = queue->size++;
+    queue->events[i] = event;
+    while (i > 0 && queue->events[(i - 1) / 2].time > queue->events[i].time)
+    {
+        event_queue_swap(queue, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+
+// Only pops events up to the given time
+bool event_queue_pop(struct EventQueue* queue, double until, struct Event* event)
+{
+    if (queue->size == 0 || queue->events[0].time > until)
+        return false;
+
+    *event = queue->events[0];
+    queue->events[0] = queue->events[--queue->size];
+    event_queue_sift_down(queue, 0);
+    return true;
+}
+
+
+bool event_is_current(const struct EventQueue* queue, const struct Event* event)
+{
+    return event->epoch == queue->epochs[event->collider];
+}
+
+
+struct BallPath ball_path(const struct GameState* state)
+{
+    const struct Ball* ball = &state->objects.ball;
+    const unsigned int settings = (unsigned int)state->settings.make_bottom_hitbox | (unsigned int)state->settings.paddle_has_hitbox << 1 | (unsigned int)state->settings.auto_move << 2;
+    return (struct BallPath){ ball->center, ball->direction, ball->speed, ball->radius, state->width, state->height, settings };
+}
+
+
+// Searches one collider from the ball's position up to the horizon and queues what it finds under a new epoch.
+// Returns the time of the event, the horizon if there is none
+double ball_schedule(const struct GameState* state, struct EventQueue* queue, enum Collider collider, double horizon)
+{
+    void (*const search[ColliderCount])(const struct GameState*, struct Impact*) = { ball_walls_impact, ball_paddle_impact, ball_bricks_impact };
+    queue->epochs[collider]++;
+
+    struct Impact impact = { .toi = (float)MIN(horizon - queue->now, (double)FLT_MAX), .kind = ImpactNone };
+    search[collider](state, &impact);
+    if (impact.kind == ImpactNone)
+        return horizon;
+
+    const struct Event event = { queue->now + impact.toi, impact, collider, queue->epochs[collider] };
+    event_queue_push(queue, event);
+    return event.time;
+}
+
+
+// A new path invalidates every event, the walls are searched first since nothing behind them can be hit
+void ball_schedule_all(const struct GameState* state, struct EventQueue* queue)
+{
+    queue->horizon = ball_schedule(state, queue, ColliderWalls, EVENT_TIME_NEVER);
+
+    // a ball that doesn't move never hits anything
+    if (queue->horizon == EVENT_TIME_NEVER)
+    {
+        queue->epochs[ColliderPaddle]++;
+        queue->epochs[ColliderBricks]++;
+        return;
+    }
+    ball_schedule(state, queue, ColliderPaddle, queue->horizon);
+    ball_schedule(state, queue, ColliderBricks, queue->horizon);
+}
+
+
+// The game can move the ball, the paddle and the walls between steps (speed keys, input, resizes, settings),
+// whatever the queued events no longer fit is searched again
+void ball_schedule_sync(const struct GameState* state, struct EventQueue* queue)
+{
+    const struct BallPath path = ball_path(state);
+    if (!queue->scheduled || memcmp(&path, &queue->path, sizeof(path)) != 0)
+    {
+        queue->scheduled = true;
+        queue->path = path;
+        queue->paddle = state->objects.paddle;
+        ball_schedule_all(state, queue);
+        return;
+    }
+
+    // an auto moved paddle is always under the ball, its event doesn't depend on where it is
+    const Rectangle paddle = state->objects.paddle;
+    if (!state->settings.auto_move && memcmp(&paddle, &queue->paddle, sizeof(paddle)) != 0)
+    {
+        queue->paddle = paddle;
+        if (queue->horizon != EVENT_TIME_NEVER)
+            ball_schedule(state, queue, ColliderPaddle, queue->horizon);
+    }
+}
+
+
+void ball_advance(struct Ball* ball, float time)
+{
+    ball->center.x += ball->direction.x * ball->speed * time;
+    ball->center.y += ball->direction.y * ball->speed * time;
+}
+
+
+// Jumps from one collision straight to the next. The queue is kept across steps, so a step without a
+// collision only moves the ball and the cost depends on the number of collisions, not on the number of steps
+bool ball_move_events(struct GameState* state, float dt, struct GameEvents* events)
+{
+    struct Ball* ball = &state->objects.ball;
+    struct EventQueue* queue = &state->objects.event_queue;
+    ball_animate_tail(ball, dt);
+
+    if (!state->settings.make_bottom_hitbox && ball->center.y + ball->radius >= state->height)
+        return false;
+
+    ball_schedule_sync(state, queue);
+    const double end = queue->now + dt;
+
+    struct Event event;
+    size_t handled = 0;
+    while (handled < BALL_MAX_EVENTS && event_queue_pop(queue, end, &event))
+    {
+        if (!event_is_current(queue, &event))
+            continue;
+
+        ball_advance(ball, (float)(event.time - queue->now));
+        queue->now = event.time;
+
+        // an extra ball took the brick away, the ball flies on to whatever is behind it
+        if (event.impact.kind == ImpactBrick && !bitset_test(state->objects.bricks.alive, event.impact.brick))
+        {
+            ball_schedule(state, queue, ColliderBricks, queue->horizon);
+            continue;
+        }
+
+        if (event.impact.kind == ImpactBottom)
+            return false;
+        ball_resolve_impact(state, &event.impact, events);
+
+        ++handled;
+        ball_schedule_all(state, queue);
+    }
+
+    // a ball stuck between colliders stays where it is, the next step searches everything again
+    if (handled < BALL_MAX_EVENTS)
+        ball_advance(ball, (float)(end - queue->now));
+    else
+        queue->scheduled = false;
+    queue->now = end;
+    queue->path = ball_path(state);
+    return true;
+}
+
+
+// Straight line movement and the side and top walls, branch free over plain arrays so the compiler can vectorize it
+void extra_balls_integrate(struct ExtraBalls* balls, size_t first, size_t last, float radius, float width, float dt)
+{
+    float* restrict x = balls->x;
+    float* restrict y = balls->y;
+    float* restrict velocity_x = balls->velocity_x;
+    float* restrict velocity_y = balls->velocity_y;
+    const float right = width - radius;
+    for (size_t i = first; i < last; ++i)
+    {
+        x[i] += velocity_x[i] * dt;
+        y[i] += velocity_y[i] * dt;
+        velocity_x[i] = x[i] < radius ? fabsf(velocity_x[i]) : (x[i] > right ? -fabsf(velocity_x[i]) : velocity_x[i]);
+        velocity_y[i] = y[i] < radius ? fabsf(velocity_y[i]) : velocity_y[i];
+        x[i] = MIN(MAX(x[i], radius), right);
+        y[i] = MAX(y[i], radius);
+    }
+}
+
+
+// First alive brick the ball overlaps, only the cells under the ball are looked at. Returns the brick count if there is none
+size_t extra_ball_find_brick(const struct GameObjects* objects, float x, float y, float radius)
+{
+    const struct Bricks* bricks = &objects->bricks;
+    const struct BrickGrid* grid = &objects->grid;
+    if (y + radius < grid->y || y - radius > grid->y + grid->cell_height * grid->rows)
+        return bricks->count;
+
+    const int first_row = grid_clamp_cell(floorf((y - radius - grid->y) / grid->cell_height), grid->rows);
+    const int last_row = grid_clamp_cell(floorf((y + radius - grid->y) / grid->cell_height), grid->rows);
+    const int first_col = grid_clamp_cell(floorf((x - radius - grid->x) / grid->cell_width), grid->cols);
+    const int last_col = grid_clamp_cell(floorf((x + radius - grid->x) / grid->cell_width), grid->cols);
+    for (int row = first_row; row <= last_row; ++row)
+    {
+        // the cells of a row are consecutive indices, from the first alive brick on they are tested 64 at a time
+        const size_t end = (size_t)row * grid->cols + last_col + 1;
+        for (size_t first = bitset_next(bricks->alive, end, (size_t)row * grid->cols + first_col); first < end; first = bitset_next(bricks->alive, end, first + 64))
+        {
+            const uint64_t alive = bitset_window(bricks->alive, end, first) & (~(uint64_t)0 >> (64 - MIN(end - first, 64)));
+            const uint64_t hits = circle_overlaps_recs(x, y, radius, bricks->x + first, bricks->y + first, bricks->width + first, bricks->height + first, alive);
+            if (hits != 0)
+                return first + (size_t)count_trailing_zeros(hits);
+        }
+    }
+    return bricks->count;
+}
+
+
+// Parallel phase, every ball only touches its own data and the bricks are only read.
+// Collisions are found by overlap after moving (no sweep) since extra balls are many and cheap
+void extra_balls_move_range(void* context, size_t first, size_t last, int worker)
+{
+    struct BallsPhase* phase = context;
+    const struct GameState* state = phase->state;
+    struct ExtraBalls* balls = &phase->state->objects.extra_balls;
+    const Rectangle paddle = state->objects.paddle;
+    const float radius = state->objects.ball.radius;
+    struct BallsWorker* result = &phase->workers[worker];
+    result->first = first;
+    result->contacts = 0;
+    result->flags = 0;
+
+    extra_balls_integrate(balls, first, last, radius, state->width, phase->dt);
+    for (size_t i = first; i < last; ++i)
+    {
+        if (balls->y[i] + radius >= state->height)
+        {
+            if (!state->settings.make_bottom_hitbox)
+            {
+                balls->contacts[first + result->contacts++] = (struct BallContact){ (uint32_t)i, CONTACT_LOST };
+                continue;
+            }
+            balls->velocity_y[i] = -fabsf(balls->velocity_y[i]);
+        }
+
+        if (state->settings.paddle_has_hitbox && balls->velocity_y[i] > 0 && circle_overlaps_rec(balls->x[i], balls->y[i], radius, paddle))
+        {
+            balls->velocity_y[i] = -balls->velocity_y[i];
+            result->flags |= EventHitPaddle;
+        }
+
+        const size_t brick = extra_ball_find_brick(&state->objects, balls->x[i], balls->y[i], radius);
+        if (brick != state->objects.bricks.count)
+            balls->contacts[first + result->contacts++] = (struct BallContact){ (uint32_t)i, (uint32_t)brick };
+    }
+}
+
+
+// Bounces off the side of the brick that is closest to the center
+void extra_ball_bounce(struct ExtraBalls* balls, size_t i, Rectangle rec)
+{
+    const float dx = balls->x[i] - MAX(rec.x, MIN(balls->x[i], rec.x + rec.width));
+    const float dy = balls->y[i] - MAX(rec.y, MIN(balls->y[i], rec.y + rec.height));
+    if (fabsf(dx) > fabsf(dy))
+        balls->velocity_x[i] = dx > 0 ? fabsf(balls->velocity_x[i]) : -fabsf(balls->velocity_x[i]);
+    else
+        balls->velocity_y[i] = dy > 0 ? fabsf(balls->velocity_y[i]) : -fabsf(balls->velocity_y[i]);
+}
+
+
+// Moves the extra balls on the thread pool, then resolves what they hit on the calling thread.
+// The contacts are merged in ball order, so if two balls hit the same brick the lower index gets it
+// and the other one flies on. The outcome is the same for any number of threads.
+void extra_balls_step(struct GameState* state, float dt, struct GameEvents* events)
+{
+    struct ExtraBalls* balls = &state->objects.extra_balls;
+    struct Bricks* bricks = &state->objects.bricks;
+
+    struct BallsPhase phase;
+    phase.state = state;
+    phase.dt = dt;
+    struct ThreadPool* pool = balls->count >= BALLS_PARALLEL_MIN ? state->pool : NULL;
+    const int workers = thread_pool_threads(pool);
+    thread_pool_run(pool, extra_balls_move_range, &phase, balls->count);
+
+    for (int w = 0; w < workers; ++w)
+    {
+        const struct BallsWorker* worker = &phase.workers[w];
+        events->flags |= worker->flags;
+        for (size_t k = worker->first; k < worker->first + worker->contacts; ++k)
+        {
+            const struct BallContact contact = balls->contacts[k];
+            if (contact.brick == CONTACT_LOST || !bitset_test(bricks->alive, contact.brick))
+                continue;
+            extra_ball_bounce(balls, contact.ball, (Rectangle){ bricks->x[contact.brick], bricks->y[contact.brick], bricks->width[contact.brick], bricks->height[contact.brick] });
+            brick_hit(state, contact.brick, events);
+        }
+    }
+
+    // lost balls are replaced by the last one, backwards so that one is never a lost ball itself
+    for (int w = workers; w-- > 0;)
+    {
+        const struct BallsWorker* worker = &phase.workers[w];
+        for (size_t k = worker->first + worker->contacts; k-- > worker->first;)
+        {
+            const struct BallContact contact = balls->contacts[k];
+            if (contact.brick != CONTACT_LOST)
+                continue;
+            const size_t last = --balls->count;
+            balls->x[contact.ball] = balls->x[last];
+            balls->y[contact.ball] = balls->y[last];
+            balls->velocity_x[contact.ball] = balls->velocity_x[last];
+            balls->velocity_y[contact.ball] = balls->velocity_y[last];
+        }
+    }
+}
+
+
+// The last extra ball takes over once the main ball is lost
+bool extra_balls_promote(struct GameObjects* objects)
+{
+    struct ExtraBalls* balls = &objects->extra_balls;
+    if (balls->count == 0)
+        return false;
+
+    const size_t last = --balls->count;
+    struct Ball* ball = &objects->ball;
+    ball->speed = sqrtf(balls->velocity_x[last] * balls->velocity_x[last] + balls->velocity_y[last] * balls->velocity_y[last]);
+    ball->center = (Vector2){ balls->x[last], balls->y[last] };
+    ball->direction = (Vector2){ balls->velocity_x[last] / ball->speed, balls->velocity_y[last] / ball->speed };
+    ball->prev_direction = ball->direction;
+    ball->tail.p1 = ball->center;
+    ball->tail.p2 = ball->center;
+    ball->tail.p3 = ball->center;
+    return true;
+}
+
+
+void paddle_apply_input(Rectangle* paddle, const struct InputFrame* input, float window_width, float dt)
+{
+    if (input->actions & InputMoveLeft)
+    {
+        paddle->x = MAX(0, paddle->x - PADDLE_SPEED * dt);
+    }
+
+    if (input->actions & InputMoveRight)
+    {
+        paddle->x = MIN(paddle->x + PADDLE_SPEED * dt, window_width - paddle->width);
+    }
+
+    if (input->actions & InputMouseMoved)
+    {
+        paddle->x = input->mouse_x - paddle->width / 2;
+        paddle->x = MIN(paddle->x, window_width - paddle->width);
+        paddle->x = MAX(0, paddle->x);
+    }
+}
+
+
+// One term per array allocated in game_objects_init(), in the same order
+size_t game_objects_level_size(int bricks_hor, int bricks_ver, size_t extra_balls)
+{
+    const size_t count = (size_t)bricks_hor * bricks_ver;
+    return ARENA_ARRAY_SIZE(float, extra_balls) * 4
+        + ARENA_ARRAY_SIZE(struct BallContact, extra_balls)
+        + ARENA_ARRAY_SIZE(float, count + COLLISION_OVERREAD) * 4
+        + ARENA_ARRAY_SIZE(Color, count)
+        + ARENA_ARRAY_SIZE(uint64_t, BITSET_WORDS(count));
+}
+
+
+// Everything that lives as long as the level comes from level_arena, which is reset here in one go
+struct GameObjects game_objects_init(struct Arena* level_arena, int window_width, int window_height, int bricks_hor, int bricks_ver, size_t extra_balls, int paddle_width, int paddle_height, float ball_speed /* we dont want to reset the ball speed */)
+{
+    arena_reset(level_arena);
+
+    struct GameObjects objects;
+    objects.score = 0;
+    objects.event_queue = (struct EventQueue){ .size = 0, .scheduled = false };
+    objects.grid.cols = bricks_hor;
+    objects.grid.rows = bricks_ver;
+    struct ExtraBalls* balls = &objects.extra_balls;
+    balls->count = 0;
+    balls->capacity = MIN(extra_balls, EXTRA_BALLS_MAX);
+    balls->x = ARENA_ALLOC_ARRAY(level_arena, float, balls->capacity);
+    balls->y = ARENA_ALLOC_ARRAY(level_arena, float, balls->capacity);
+    balls->velocity_x = ARENA_ALLOC_ARRAY(level_arena, float, balls->capacity);
+    balls->velocity_y = ARENA_ALLOC_ARRAY(level_arena, float, balls->capacity);
+    balls->contacts = ARENA_ALLOC_ARRAY(level_arena, struct BallContact, balls->capacity);
+
+    struct Bricks* bricks = &objects.bricks;
+    bricks->count = (size_t)bricks_hor * bricks_ver;
+    // circle_overlaps_recs() may read past the last brick
+    bricks->x = ARENA_ALLOC_ARRAY(level_arena, float, bricks->count + COLLISION_OVERREAD);
+    bricks->y = ARENA_ALLOC_ARRAY(level_arena, float, bricks->count + COLLISION_OVERREAD);
+    bricks->width = ARENA_ALLOC_ARRAY(level_arena, float, bricks->count + COLLISION_OVERREAD);
+    bricks->height = ARENA_ALLOC_ARRAY(level_arena, float, bricks->count + COLLISION_OVERREAD);
+    bricks->color = ARENA_ALLOC_ARRAY(level_arena, Color, bricks->count);
+    bricks->alive = ARENA_ALLOC_ARRAY(level_arena, uint64_t, BITSET_WORDS(bricks->count));
+    // a failed allocation doesn't use up the arena, a smaller one after it can still succeed, so every array is checked
+    const void* arrays[] = { balls->x, balls->y, balls->velocity_x, balls->velocity_y, balls->contacts, bricks->x, bricks->y, bricks->width, bricks->height, bricks->color, bricks->alive };
+    bool allocated = true;
+    for (size_t i = 0; i < ARRAY_SIZE(arrays); ++i)
+        allocated = allocated && arrays[i] != NULL;
+    if (!allocated)
+    {
+        bricks->count = 0;
+        balls->capacity = 0;
+    }
+    else
+    {
+        float* const padded[] = { bricks->x, bricks->y, bricks->width, bricks->height };
+        for (size_t i = 0; i < ARRAY_SIZE(padded); ++i)
+            memset(padded[i] + bricks->count, 0, COLLISION_OVERREAD * sizeof(float));
+    }
+
+    objects.paddle = (Rectangle) { (window_width - paddle_width) / 2.f, window_height - 60, paddle_width, paddle_height };
+    objects.ball = (struct Ball){ { objects.paddle.x + paddle_width / 2.f, objects.paddle.y - 20 }, 15.f, ball_speed, { 1.4f, -1 }, { 0, 0 } };
+    objects.ball.tail.p1 = (Vector2) { objects.ball.center.x - 7.f, objects.paddle.y };
+    objects.ball.tail.p2 = (Vector2){ objects.ball.center.x + 7.f, objects.paddle.y };
+    objects.ball.tail.p3 = (Vector2) { objects.paddle.x + paddle_width / 2.f, objects.paddle.y };
+    generate_bricks(&objects, window_width, paddle_height);
+    return objects;
+}
+
+
+// splitmix64, small and good enough to vary games
+uint64_t random_next(uint64_t* state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+
+// Launches the ball in a direction picked by the seed, 0 keeps the default one
+void game_objects_seed(struct GameObjects* objects, uint64_t seed)
+{
+    if (seed == 0)
+        return;
+
+    // the default direction isn't normalized and its length is part of the ball speed, keep it
+    const float length = sqrtf(1.4f * 1.4f + 1.f);
+    const float t = (random_next(&seed) >> 40) / (float)(1 << 24);
+    const float angle = 0.45f + t * 0.7f; // 26 to 66 degrees above the horizon
+    const float side = random_next(&seed) & 1 ? 1.f : -1.f;
+    objects->ball.direction = (Vector2){ cosf(angle) * length * side, -sinf(angle) * length };
+}
+
+
+float game_time_to_event(struct GameState* state)
+{
+    if (!state->settings.event_driven || state->objects.extra_balls.count > 0)
+        return 0;
+
+    struct EventQueue* queue = &state->objects.event_queue;
+    ball_schedule_sync(state, queue);
+
+    // outdated events on top would end the skip early
+    struct Event event;
+    while (queue->size > 0 && !event_is_current(queue, &queue->events[0]))
+        event_queue_pop(queue, EVENT_TIME_NEVER, &event);
+    return queue->size > 0 ? (float)MIN(queue->events[0].time - queue->now, (double)FLT_MAX) : FLT_MAX;
+}
+
+
+void game_step(struct GameState* state, const struct InputFrame* input, float dt, struct GameEvents* events)
+{
+    struct GameObjects* objects = &state->objects;
+    events->flags = 0;
+    events->bricks_hit = 0;
+
+    paddle_apply_input(&objects->paddle, input, state->width, dt);
+    if (input->actions & InputSpawnBalls)
+        extra_balls_spawn(state, EXTRA_BALLS_STRESS);
+
+    const bool ball_alive = state->settings.event_driven ? ball_move_events(state, dt, events) : ball_move(state, dt, events);
+    if (!ball_alive && !extra_balls_promote(objects))
+    {
+        events->flags |= EventFailed;
+        return;
+    }
+
+    extra_balls_step(state, dt, events);
+
+    if (state->settings.auto_move)
+        paddle_follow_ball(state);
+
+    if (objects->score == objects->bricks.count)
+    {
+        events->flags |= EventSuccess;
+    }
+}
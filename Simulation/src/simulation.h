@@ -0,0 +1,243 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <float.h>
+
+/*
+    Only the plain data types (Vector2, Rectangle, Color) are taken from raylib.
+    The simulation never calls into raylib, so it can be stepped without a window,
+    an OpenGL context or an audio device.
+*/
+#include "raylib.h"
+
+#include "arena.h"
+#include "bitset.h"
+#include "thread_pool.h"
+
+#define BRICKS_HOR     10   // default num of horizontal bricks
+#define BRICKS_VER     7    // default num of vertical bricks
+#define BRICKS_MAX     1024 // per direction
+#define BRICK_PADDING  5
+#define BRICK_ROW_GAP  5
+#define BRICK_Y_OFFSET 60
+
+#define PADDLE_SPEED   1250.f
+
+#define EVENT_QUEUE_CAPACITY 32
+#define EVENT_TIME_NEVER     DBL_MAX // finite, Release builds with fast math which assumes there are no infinities
+
+#define EXTRA_BALLS_MAX    16384 // balls next to the main one
+#define EXTRA_BALLS_STRESS 1000  // spawned at once by InputSpawnBalls
+#define MULTI_BALL_EVERY   10    // every n-th brick spawns MULTI_BALL_SPAWN balls if multi_ball is on
+#define MULTI_BALL_SPAWN   2
+
+
+// Structure of arrays, every array is count long and allocated from the level arena
+struct Bricks
+{
+    float* x;
+    float* y;
+    float* width;
+    float* height;
+    Color* color;
+    uint64_t* alive; // bit i is set while brick i hasn't been hit
+    size_t count;
+};
+
+
+// Iterates the indices of all alive bricks
+#define BRICKS_FOR_EACH_ALIVE(bricks, i) for (size_t i = bitset_next((bricks)->alive, (bricks)->count, 0); i < (bricks)->count; i = bitset_next((bricks)->alive, (bricks)->count, i + 1))
+
+
+// Brick (col, row) is at index row * cols + col and lies inside cell (col, row)
+struct BrickGrid
+{
+    int cols;
+    int rows;
+    float x; // top left corner of cell (0, 0)
+    float y;
+    float cell_width;  // brick plus padding
+    float cell_height;
+};
+
+
+struct Tail
+{
+    Vector2 p1;
+    Vector2 p2;
+    Vector2 p3;
+};
+
+
+struct Ball
+{
+    Vector2 center;
+    float radius;
+    float speed;
+    Vector2 direction;
+    Vector2 prev_direction;
+    struct Tail tail;
+};
+
+
+// Balls without a tail, stored as structure of arrays. They share the radius of the main ball
+struct ExtraBalls
+{
+    float* x;
+    float* y;
+    float* velocity_x;
+    float* velocity_y;
+    struct BallContact* contacts; // scratch of the collision phase, one per ball
+    size_t count;
+    size_t capacity;
+};
+
+
+enum ImpactKind
+{
+    ImpactNone,
+    ImpactWall,
+    ImpactBottom,
+    ImpactPaddle,
+    ImpactBrick
+};
+
+
+struct Impact
+{
+    float toi;      // time of impact in seconds from now
+    Vector2 normal; // axis aligned, points away from what was hit
+    enum ImpactKind kind;
+    size_t brick;
+};
+
+
+// What the main ball can hit, each one is searched on its own and has an event in the queue
+enum Collider
+{
+    ColliderWalls,
+    ColliderPaddle,
+    ColliderBricks,
+    ColliderCount
+};
+
+
+struct Event
+{
+    double time;          // on the clock of the queue
+    struct Impact impact; // toi is the time since the search
+    enum Collider collider;
+    unsigned int epoch;   // of the collider when the event was computed, older ones are dropped
+};
+
+
+// The ball and the field as they were when the events were computed
+struct BallPath
+{
+    Vector2 center;
+    Vector2 direction;
+    float speed;
+    float radius;
+    float width;
+    float height;
+    unsigned int settings; // the ones that change what the ball collides with
+};
+
+
+// Upcoming collisions of the main ball in event driven mode, a binary min heap ordered by time.
+// The events stay valid across steps, only a changed path or collider is searched again
+struct EventQueue
+{
+    struct Event events[EVENT_QUEUE_CAPACITY];
+    size_t size;
+    double now;     // the ball's position is the one at this time
+    double horizon; // time the ball hits a wall, nothing behind it is searched. EVENT_TIME_NEVER if it doesn't move
+    unsigned int epochs[ColliderCount];
+    bool scheduled; // false until the first search and whenever the path was lost track of
+    struct BallPath path;
+    Rectangle paddle;
+};
+
+
+struct GameObjects
+{
+    struct Bricks bricks;
+    struct BrickGrid grid;
+    Rectangle paddle;
+    struct Ball ball;
+    struct ExtraBalls extra_balls;
+    struct EventQueue event_queue; // only used in event driven mode
+    size_t score;
+};
+
+
+struct GameSettings
+{
+    bool make_bottom_hitbox;
+    bool paddle_has_hitbox;
+    bool show_stats;
+    bool increase_ball_speed;
+    bool auto_restart;
+    bool auto_move;
+    bool event_driven; // jump from collision to collision instead of sweeping each step
+    bool multi_ball;
+};
+
+
+struct GameState
+{
+    struct GameObjects objects;
+    struct GameSettings settings;
+    struct ThreadPool* pool; // moves the extra balls, NULL runs everything on the calling thread
+    float width;
+    float height;
+};
+
+
+// Everything the simulation needs to know about the player for one step
+enum InputAction
+{
+    InputMoveLeft   = 1 << 0,
+    InputMoveRight  = 1 << 1,
+    InputMouseMoved = 1 << 2, // mouse_x is only valid if this is set
+    InputSpawnBalls = 1 << 3  // stress test, spawns EXTRA_BALLS_STRESS balls
+};
+
+
+struct InputFrame
+{
+    unsigned int actions;
+    float mouse_x;
+};
+
+
+// Things that happened during a step, the caller decides how to present them (sounds, stats...)
+enum GameEvent
+{
+    EventHitBrick  = 1 << 0,
+    EventHitPaddle = 1 << 1,
+    EventFailed    = 1 << 2,
+    EventSuccess   = 1 << 3
+};
+
+
+struct GameEvents
+{
+    unsigned int flags;
+    size_t bricks_hit;
+};
+
+
+void bricks_layout(struct GameObjects* objects, int window_width, float brick_height);
+// extra_balls is the most balls the level can spawn, EXTRA_BALLS_MAX if multi_ball or InputSpawnBalls can be used, otherwise 0
+size_t game_objects_level_size(int bricks_hor, int bricks_ver, size_t extra_balls); // arena capacity a level of this size needs
+struct GameObjects game_objects_init(struct Arena* level_arena, int window_width, int window_height, int bricks_hor, int bricks_ver, size_t extra_balls, int paddle_width, int paddle_height, float ball_speed /* we dont want to reset the ball speed */);
+void game_objects_seed(struct GameObjects* objects, uint64_t seed);
+void game_step(struct GameState* state, const struct InputFrame* input, float dt, struct GameEvents* events);
+// Seconds the main ball flies straight from now on, steps until then can be taken at once as long as the input doesn't change.
+// 0 unless the game is event driven and there are no extra balls, FLT_MAX if the ball never hits anything
+float game_time_to_event(struct GameState* state);
+
+#endif // SIMULATION_H
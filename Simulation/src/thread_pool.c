@@ -0,0 +1,232 @@
+#if defined(_WIN32)
+    #define THREAD_POOL_WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#elif defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    #define THREAD_POOL_SERIAL
+#else
+    #define THREAD_POOL_PTHREAD
+    #define _POSIX_C_SOURCE 200809L
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "thread_pool.h"
+
+
+struct ThreadPoolWorker
+{
+    struct ThreadPool* pool;
+    int index;
+};
+
+
+struct ThreadPool
+{
+    int threads;
+    struct ThreadPoolWorker workers[THREAD_POOL_MAX];
+#if defined(THREAD_POOL_WIN32)
+    HANDLE handles[THREAD_POOL_MAX];
+    SRWLOCK lock;
+    CONDITION_VARIABLE start;
+    CONDITION_VARIABLE done;
+#elif defined(THREAD_POOL_PTHREAD)
+    pthread_t handles[THREAD_POOL_MAX];
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+#endif
+    ThreadPoolTask task;
+    void* context;
+    size_t count;
+    unsigned int generation; // bumped for every run, the workers wait for it to change
+    int pending;             // workers that haven't finished the current run
+    bool quit;
+};
+
+
+// The lock and the two condition variables are the only platform specific parts besides starting the threads
+#if defined(THREAD_POOL_WIN32)
+    #define POOL_LOCK(pool)            AcquireSRWLockExclusive(&(pool)->lock)
+    #define POOL_UNLOCK(pool)          ReleaseSRWLockExclusive(&(pool)->lock)
+    #define POOL_WAIT(pool, cond)      SleepConditionVariableSRW(&(pool)->cond, &(pool)->lock, INFINITE, 0)
+    #define POOL_BROADCAST(pool, cond) WakeAllConditionVariable(&(pool)->cond)
+#elif defined(THREAD_POOL_PTHREAD)
+    #define POOL_LOCK(pool)            pthread_mutex_lock(&(pool)->lock)
+    #define POOL_UNLOCK(pool)          pthread_mutex_unlock(&(pool)->lock)
+    #define POOL_WAIT(pool, cond)      pthread_cond_wait(&(pool)->cond, &(pool)->lock)
+    #define POOL_BROADCAST(pool, cond) pthread_cond_broadcast(&(pool)->cond)
+#endif
+
+
+void thread_pool_run_range(struct ThreadPool* pool, int worker)
+{
+    const size_t first = pool->count * worker / pool->threads;
+    const size_t last = pool->count * (worker + 1) / pool->threads;
+    pool->task(pool->context, first, last, worker);
+}
+
+
+#if !defined(THREAD_POOL_SERIAL)
+void thread_pool_work(struct ThreadPoolWorker* worker)
+{
+    struct ThreadPool* pool = worker->pool;
+    unsigned int generation = 0;
+    for (;;)
+    {
+        POOL_LOCK(pool);
+        while (pool->generation == generation && !pool->quit)
+            POOL_WAIT(pool, start);
+        if (pool->quit)
+        {
+            POOL_UNLOCK(pool);
+            return;
+        }
+        generation = pool->generation;
+        POOL_UNLOCK(pool);
+
+        thread_pool_run_range(pool, worker->index);
+
+        POOL_LOCK(pool);
+        if (--pool->pending == 0)
+            POOL_BROADCAST(pool, done);
+        POOL_UNLOCK(pool);
+    }
+}
+#endif
+
+
+#if defined(THREAD_POOL_WIN32)
+DWORD WINAPI thread_pool_entry(LPVOID worker)
+{
+    thread_pool_work((struct ThreadPoolWorker*)worker);
+    return 0;
+}
+#elif defined(THREAD_POOL_PTHREAD)
+void* thread_pool_entry(void* worker)
+{
+    thread_pool_work((struct ThreadPoolWorker*)worker);
+    return NULL;
+}
+#endif
+
+
+int thread_pool_hardware_threads(void)
+{
+#if defined(THREAD_POOL_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    const int threads = (int)info.dwNumberOfProcessors;
+#elif defined(THREAD_POOL_PTHREAD)
+    const int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#else
+    const int threads = 1;
+#endif
+    return threads < 1 ? 1 : (threads > THREAD_POOL_MAX ? THREAD_POOL_MAX : threads);
+}
+
+
+struct ThreadPool* thread_pool_create(int threads)
+{
+    struct ThreadPool* pool = calloc(1, sizeof(struct ThreadPool));
+    if (pool == NULL)
+        return NULL;
+
+    threads = threads < 1 ? 1 : (threads > THREAD_POOL_MAX ? THREAD_POOL_MAX : threads);
+#if defined(THREAD_POOL_SERIAL)
+    threads = 1;
+#elif defined(THREAD_POOL_WIN32)
+    InitializeSRWLock(&pool->lock);
+    InitializeConditionVariable(&pool->start);
+    InitializeConditionVariable(&pool->done);
+#else
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+#endif
+
+    // worker 0 is the calling thread, if starting a thread fails the pool just gets smaller
+    pool->threads = 1;
+    for (int i = 1; i < threads; ++i)
+    {
+        pool->workers[i] = (struct ThreadPoolWorker){ pool, i };
+#if defined(THREAD_POOL_WIN32)
+        pool->handles[i] = CreateThread(NULL, 0, thread_pool_entry, &pool->workers[i], 0, NULL);
+        if (pool->handles[i] == NULL)
+            break;
+#elif defined(THREAD_POOL_PTHREAD)
+        if (pthread_create(&pool->handles[i], NULL, thread_pool_entry, &pool->workers[i]) != 0)
+            break;
+#endif
+        pool->threads++;
+    }
+    return pool;
+}
+
+
+void thread_pool_destroy(struct ThreadPool* pool)
+{
+    if (pool == NULL)
+        return;
+
+#if !defined(THREAD_POOL_SERIAL)
+    POOL_LOCK(pool);
+    pool->quit = true;
+    POOL_BROADCAST(pool, start);
+    POOL_UNLOCK(pool);
+
+    for (int i = 1; i < pool->threads; ++i)
+    {
+    #if defined(THREAD_POOL_WIN32)
+        WaitForSingleObject(pool->handles[i], INFINITE);
+        CloseHandle(pool->handles[i]);
+    #else
+        pthread_join(pool->handles[i], NULL);
+    #endif
+    }
+
+    #if defined(THREAD_POOL_PTHREAD)
+        pthread_cond_destroy(&pool->done);
+        pthread_cond_destroy(&pool->start);
+        pthread_mutex_destroy(&pool->lock);
+    #endif
+#endif
+    free(pool);
+}
+
+
+int thread_pool_threads(const struct ThreadPool* pool)
+{
+    return pool != NULL ? pool->threads : 1;
+}
+
+
+void thread_pool_run(struct ThreadPool* pool, ThreadPoolTask task, void* context, size_t count)
+{
+    if (pool == NULL || pool->threads == 1)
+    {
+        task(context, 0, count, 0);
+        return;
+    }
+
+#if !defined(THREAD_POOL_SERIAL)
+    POOL_LOCK(pool);
+    pool->task = task;
+    pool->context = context;
+    pool->count = count;
+    pool->pending = pool->threads - 1;
+    pool->generation++;
+    POOL_BROADCAST(pool, start);
+    POOL_UNLOCK(pool);
+
+    thread_pool_run_range(pool, 0);
+
+    POOL_LOCK(pool);
+    while (pool->pending != 0)
+        POOL_WAIT(pool, done);
+    POOL_UNLOCK(pool);
+#endif
+}
@@ -0,0 +1,28 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stddef.h>
+
+#define THREAD_POOL_MAX 64 // threads including the calling one
+
+/*
+    Fixed set of worker threads that split a range of items between them.
+    The calling thread takes part in every run, a pool of 1 thread (or a build without
+    thread support like the web) simply runs everything on the calling thread.
+    The pool is opaque so the platform headers don't leak into the game (windows.h and raylib.h clash).
+*/
+struct ThreadPool;
+
+// Processes the items [first, last), worker is in [0, thread count) and the ranges ascend with it
+typedef void (*ThreadPoolTask)(void* context, size_t first, size_t last, int worker);
+
+
+struct ThreadPool* thread_pool_create(int threads); // NULL on failure
+void thread_pool_destroy(struct ThreadPool* pool);
+int thread_pool_threads(const struct ThreadPool* pool);
+int thread_pool_hardware_threads(void);
+
+// Splits [0, count) into one contiguous range per thread and returns once all of them are done
+void thread_pool_run(struct ThreadPool* pool, ThreadPoolTask task, void* context, size_t count);
+
+#endif // THREAD_POOL_H
@@ -1,3 +1,8 @@
+newoption {
+    trigger = "trace",
+    description = "Record trace zones (raylib and the game) to breakout_trace.json for chrome://tracing or ui.perfetto.dev"
+}
+
 workspace "Breakout"
     configurations {
         "Debug",
@@ -11,6 +16,7 @@ targetdir(cwd .. outputdir .. "bin")
 objdir(cwd .. outputdir .. "bin-int")
 
 RaylibDir = cwd .. "/Dependencies/raylib"
+SimulationDir = cwd .. "/Simulation"
 
 
 filter "system:windows"
@@ -39,5 +45,10 @@ flags {
 staticruntime "on"
 removeunreferencedcodedata "on"
 
+if _OPTIONS["trace"] then
+    defines "RL_TRACE_ZONES"
+end
+
 include "Breakout"
+include "Simulation"
 include "Dependencies/raylib"
\ No newline at end of file